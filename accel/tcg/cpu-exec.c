@@ -236,30 +236,36 @@ static inline TranslationBlock *tb_lookup(CPUState *cpu, vaddr pc,
 {
     TranslationBlock *tb;
     CPUJumpCache *jc;
-    uint32_t hash;
+    uint32_t hash, set;
 
     /* we should never be trying to look up an INVALID tb */
     tcg_debug_assert(!(cflags & CF_INVALID));
 
     hash = tb_jmp_cache_hash_func(pc);
+    set = tb_jmp_cache_set(hash);
     jc = cpu->tb_jmp_cache;
 
-    tb = qatomic_read(&jc->array[hash].tb);
-    if (likely(tb &&
-               jc->array[hash].pc == pc &&
-               tb->cs_base == cs_base &&
-               tb->flags == flags &&
-               tb_cflags(tb) == cflags)) {
-        goto hit;
+    for (int i = 0; i < 2; i++) {
+        tb = qatomic_read(&jc->array[set + i].tb);
+        if (likely(tb &&
+                   jc->array[set + i].pc == pc &&
+                   tb->cs_base == cs_base &&
+                   tb->flags == flags &&
+                   tb_cflags(tb) == cflags)) {
+            if (unlikely(tcg_jmp_cache_stats)) {
+                qatomic_set(&jc->hit_count, jc->hit_count + 1);
+            }
+            goto hit;
+        }
     }
 
+    qatomic_set(&jc->miss_count, jc->miss_count + 1);
     tb = tb_htable_lookup(cpu, pc, cs_base, flags, cflags);
     if (tb == NULL) {
         return NULL;
     }
 
-    jc->array[hash].pc = pc;
-    qatomic_set(&jc->array[hash].tb, tb);
+    tb_jmp_cache_insert(jc, hash, pc, tb);
 
 hit:
     /*
@@ -270,6 +276,32 @@ hit:
     return tb;
 }
 
+/*
+ * Translate a block that missed in tb_lookup().  In user-mode translation
+ * is serialized by mmap_lock, so check the hash table again once it is
+ * held: another thread may have published the very same block while we
+ * were waiting, and translating it twice only to discard our copy in
+ * tb_link_page() is pure overhead.
+ */
+static TranslationBlock *tb_lookup_or_gen(CPUState *cpu, vaddr pc,
+                                          uint64_t cs_base, uint32_t flags,
+                                          uint32_t cflags)
+{
+    TranslationBlock *tb;
+
+    mmap_lock();
+#ifdef CONFIG_USER_ONLY
+    tb = tb_htable_lookup(cpu, pc, cs_base, flags, cflags);
+    if (tb) {
+        mmap_unlock();
+        return tb;
+    }
+#endif
+    tb = tb_gen_code(cpu, pc, cs_base, flags, cflags);
+    mmap_unlock();
+    return tb;
+}
+
 static void log_cpu_exec(vaddr pc, CPUState *cpu,
                          const TranslationBlock *tb)
 {
@@ -385,11 +417,16 @@ static inline bool check_for_breakpoints(CPUState *cpu, vaddr pc,
 const void *HELPER(lookup_tb_ptr)(CPUArchState *env)
 {
     CPUState *cpu = env_cpu(env);
+    CPUJumpCache *jc = cpu->tb_jmp_cache;
     TranslationBlock *tb;
     vaddr pc;
     uint64_t cs_base;
     uint32_t flags, cflags;
 
+    if (unlikely(tcg_jmp_cache_stats)) {
+        qatomic_set(&jc->ptr_lookup_count, jc->ptr_lookup_count + 1);
+    }
+
     /*
      * By definition we've just finished a TB, so I/O is OK.
      * Avoid the possibility of calling cpu_io_recompile() if
@@ -407,6 +444,7 @@ const void *HELPER(lookup_tb_ptr)(CPUArchState *env)
 
     tb = tb_lookup(cpu, pc, cs_base, flags, cflags);
     if (tb == NULL) {
+        qatomic_set(&jc->ptr_exit_count, jc->ptr_exit_count + 1);
         return tcg_code_gen_epilogue;
     }
 
@@ -590,9 +628,7 @@ void cpu_exec_step_atomic(CPUState *cpu)
 
         tb = tb_lookup(cpu, pc, cs_base, flags, cflags);
         if (tb == NULL) {
-            mmap_lock();
-            tb = tb_gen_code(cpu, pc, cs_base, flags, cflags);
-            mmap_unlock();
+            tb = tb_lookup_or_gen(cpu, pc, cs_base, flags, cflags);
         }
 
         cpu_exec_enter(cpu);
@@ -980,21 +1016,14 @@ cpu_exec_loop(CPUState *cpu, SyncClocks *sc)
 
             tb = tb_lookup(cpu, pc, cs_base, flags, cflags);
             if (tb == NULL) {
-                CPUJumpCache *jc;
-                uint32_t h;
-
-                mmap_lock();
-                tb = tb_gen_code(cpu, pc, cs_base, flags, cflags);
-                mmap_unlock();
+                tb = tb_lookup_or_gen(cpu, pc, cs_base, flags, cflags);
 
                 /*
                  * We add the TB in the virtual pc hash table
                  * for the fast lookup
                  */
-                h = tb_jmp_cache_hash_func(pc);
-                jc = cpu->tb_jmp_cache;
-                jc->array[h].pc = pc;
-                qatomic_set(&jc->array[h].tb, tb);
+                tb_jmp_cache_insert(cpu->tb_jmp_cache,
+                                    tb_jmp_cache_hash_func(pc), pc, tb);
             }
 
 #ifndef CONFIG_USER_ONLY
@@ -344,25 +344,6 @@ void tlb_destroy(CPUState *cpu)
     }
 }
 
-/* flush_all_helper: run fn across all cpus
- *
- * If the wait flag is set then the src cpu's helper will be queued as
- * "safe" work and the loop exited creating a synchronisation point
- * where all queued work will be finished before execution starts
- * again.
- */
-static void flush_all_helper(CPUState *src, run_on_cpu_func fn,
-                             run_on_cpu_data d)
-{
-    CPUState *cpu;
-
-    CPU_FOREACH(cpu) {
-        if (cpu != src) {
-            async_run_on_cpu(cpu, fn, d);
-        }
-    }
-}
-
 static void tlb_flush_by_mmuidx_async_work(CPUState *cpu, run_on_cpu_data data)
 {
     uint16_t asked = data.host_int;
@@ -417,13 +398,98 @@ void tlb_flush(CPUState *cpu)
     tlb_flush_by_mmuidx(cpu, ALL_MMUIDX_BITS);
 }
 
+static void tlb_flush_pending_async_work(CPUState *cpu, run_on_cpu_data data);
+
+/**
+ * tlb_flush_queue_remote:
+ * @cpu: cpu to flush, other than the current one
+ * @req: page or range to flush, only @req->idxmap is used if @full
+ * @full: flush all of @req->idxmap rather than one page or range
+ *
+ * Instead of queuing one work item per request, merge the request with
+ * those already pending for @cpu.  Only the first request after the queue
+ * was drained needs to schedule the work item that drains it.
+ */
+static void tlb_flush_queue_remote(CPUState *cpu, const CPUTLBPendingFlush *req,
+                                   bool full)
+{
+    CPUTLBCommon *c = &cpu->neg.tlb.c;
+    uint16_t idxmap = req->idxmap;
+    bool queue_work, coalesced = false;
+    int i;
+
+    qemu_spin_lock(&c->lock);
+
+    queue_work = !c->pending_queued;
+    c->pending_queued = true;
+
+    if ((c->pending_full & idxmap) == idxmap) {
+        coalesced = true;
+    } else if (full) {
+        c->pending_full |= idxmap;
+    } else {
+        for (i = 0; i < c->pending_count; i++) {
+            CPUTLBPendingFlush *p = &c->pending[i];
+
+            if (p->addr == req->addr && p->len == req->len &&
+                p->bits == req->bits) {
+                p->idxmap |= idxmap;
+                coalesced = true;
+                break;
+            }
+        }
+        if (!coalesced) {
+            if (c->pending_count < CPU_TLB_PENDING_SIZE) {
+                c->pending[c->pending_count++] = *req;
+            } else {
+                /* Too many distinct flushes: widen to a full flush. */
+                for (i = 0; i < c->pending_count; i++) {
+                    idxmap |= c->pending[i].idxmap;
+                }
+                c->pending_full |= idxmap;
+                c->pending_count = 0;
+                coalesced = true;
+            }
+        }
+    }
+
+    if (coalesced) {
+        qatomic_set(&c->coalesced_flush_count, c->coalesced_flush_count + 1);
+    }
+
+    qemu_spin_unlock(&c->lock);
+
+    if (queue_work) {
+        async_run_on_cpu(cpu, tlb_flush_pending_async_work, RUN_ON_CPU_NULL);
+    }
+}
+
+/*
+ * Queue a flush on all cpus but @src.  The callers queue the @src part as
+ * "safe" work, creating a synchronisation point where all queued work will
+ * be finished before execution starts again.
+ */
+static void tlb_flush_queue_all_remote(CPUState *src,
+                                       const CPUTLBPendingFlush *req,
+                                       bool full)
+{
+    CPUState *cpu;
+
+    CPU_FOREACH(cpu) {
+        if (cpu != src) {
+            tlb_flush_queue_remote(cpu, req, full);
+        }
+    }
+}
+
 void tlb_flush_by_mmuidx_all_cpus_synced(CPUState *src_cpu, uint16_t idxmap)
 {
     const run_on_cpu_func fn = tlb_flush_by_mmuidx_async_work;
+    const CPUTLBPendingFlush req = { .idxmap = idxmap };
 
     tlb_debug("mmu_idx: 0x%"PRIx16"\n", idxmap);
 
-    flush_all_helper(src_cpu, fn, RUN_ON_CPU_HOST_INT(idxmap));
+    tlb_flush_queue_all_remote(src_cpu, &req, true);
     async_safe_run_on_cpu(src_cpu, fn, RUN_ON_CPU_HOST_INT(idxmap));
 }
 
@@ -496,6 +562,50 @@ static inline void tlb_flush_vtlb_page_locked(CPUState *cpu, int mmu_idx,
     tlb_flush_vtlb_page_mask_locked(cpu, mmu_idx, page, -1);
 }
 
+/**
+ * tlb_flush_large_page_locked:
+ * @cpu: cpu on which to flush
+ * @midx: mmu_idx whose large page region is being invalidated
+ *
+ * Called when a flush hits the region covering the large pages of @midx.
+ * Any entry in the region may belong to a large page, so all of them must
+ * go.  Large pages are entered one TARGET_PAGE_SIZE page at a time, so when
+ * the region is not larger than the tlb it is cheaper to drop the entries
+ * of the region one by one, which also empties the region, than to throw
+ * away the whole tlb and refill it.
+ * Returns true if the entire tlb for @midx was flushed.
+ */
+static bool tlb_flush_large_page_locked(CPUState *cpu, int midx)
+{
+    CPUTLBDesc *d = &cpu->neg.tlb.d[midx];
+    CPUTLBDescFast *f = &cpu->neg.tlb.f[midx];
+    vaddr lp_addr = d->large_page_addr;
+    vaddr lp_len = -d->large_page_mask;
+
+    if (lp_len == 0 || (lp_len >> TARGET_PAGE_BITS) > tlb_n_entries(f)) {
+        tlb_debug("forcing full flush midx %d (%016"
+                  VADDR_PRIx "/%016" VADDR_PRIx ")\n",
+                  midx, lp_addr, d->large_page_mask);
+        tlb_flush_one_mmuidx_locked(cpu, midx, get_clock_realtime());
+        return true;
+    }
+
+    tlb_debug("flushing large page region midx %d (%016"
+              VADDR_PRIx "/%016" VADDR_PRIx ")\n",
+              midx, lp_addr, d->large_page_mask);
+    for (vaddr i = 0; i < lp_len; i += TARGET_PAGE_SIZE) {
+        vaddr page = lp_addr + i;
+
+        if (tlb_flush_entry_locked(tlb_entry(cpu, midx, page), page)) {
+            tlb_n_used_entries_dec(cpu, midx);
+        }
+    }
+    tlb_flush_vtlb_page_mask_locked(cpu, midx, lp_addr, d->large_page_mask);
+    d->large_page_addr = -1;
+    d->large_page_mask = -1;
+    return false;
+}
+
 static void tlb_flush_page_locked(CPUState *cpu, int midx, vaddr page)
 {
     vaddr lp_addr = cpu->neg.tlb.d[midx].large_page_addr;
@@ -503,10 +613,7 @@ static void tlb_flush_page_locked(CPUState *cpu, int midx, vaddr page)
 
     /* Check if we need to flush due to large pages.  */
     if ((page & lp_mask) == lp_addr) {
-        tlb_debug("forcing full flush midx %d (%016"
-                  VADDR_PRIx "/%016" VADDR_PRIx ")\n",
-                  midx, lp_addr, lp_mask);
-        tlb_flush_one_mmuidx_locked(cpu, midx, get_clock_realtime());
+        tlb_flush_large_page_locked(cpu, midx);
     } else {
         if (tlb_flush_entry_locked(tlb_entry(cpu, midx, page), page)) {
             tlb_n_used_entries_dec(cpu, midx);
@@ -615,35 +722,27 @@ void tlb_flush_page_by_mmuidx_all_cpus_synced(CPUState *src_cpu,
                                               vaddr addr,
                                               uint16_t idxmap)
 {
+    CPUTLBPendingFlush req = { };
+
     tlb_debug("addr: %016" VADDR_PRIx " mmu_idx:%"PRIx16"\n", addr, idxmap);
 
     /* This should already be page aligned */
     addr &= TARGET_PAGE_MASK;
 
+    req.addr = addr;
+    req.idxmap = idxmap;
+    tlb_flush_queue_all_remote(src_cpu, &req, false);
+
     /*
      * Allocate memory to hold addr+idxmap only when needed.
      * See tlb_flush_page_by_mmuidx for details.
      */
     if (idxmap < TARGET_PAGE_SIZE) {
-        flush_all_helper(src_cpu, tlb_flush_page_by_mmuidx_async_1,
-                         RUN_ON_CPU_TARGET_PTR(addr | idxmap));
         async_safe_run_on_cpu(src_cpu, tlb_flush_page_by_mmuidx_async_1,
                               RUN_ON_CPU_TARGET_PTR(addr | idxmap));
     } else {
-        CPUState *dst_cpu;
         TLBFlushPageByMMUIdxData *d;
 
-        /* Allocate a separate data block for each destination cpu.  */
-        CPU_FOREACH(dst_cpu) {
-            if (dst_cpu != src_cpu) {
-                d = g_new(TLBFlushPageByMMUIdxData, 1);
-                d->addr = addr;
-                d->idxmap = idxmap;
-                async_run_on_cpu(dst_cpu, tlb_flush_page_by_mmuidx_async_2,
-                                 RUN_ON_CPU_HOST_PTR(d));
-            }
-        }
-
         d = g_new(TLBFlushPageByMMUIdxData, 1);
         d->addr = addr;
         d->idxmap = idxmap;
@@ -688,11 +787,8 @@ static void tlb_flush_range_locked(CPUState *cpu, int midx,
      * Because large_page_mask contains all 1's from the msb,
      * we only need to test the end of the range.
      */
-    if (((addr + len - 1) & d->large_page_mask) == d->large_page_addr) {
-        tlb_debug("forcing full flush midx %d ("
-                  "%016" VADDR_PRIx "/%016" VADDR_PRIx ")\n",
-                  midx, d->large_page_addr, d->large_page_mask);
-        tlb_flush_one_mmuidx_locked(cpu, midx, get_clock_realtime());
+    if (((addr + len - 1) & d->large_page_mask) == d->large_page_addr &&
+        tlb_flush_large_page_locked(cpu, midx)) {
         return;
     }
 
@@ -760,6 +856,52 @@ static void tlb_flush_range_by_mmuidx_async_1(CPUState *cpu,
     g_free(d);
 }
 
+/**
+ * tlb_flush_pending_async_work:
+ * @cpu: cpu on which to flush
+ *
+ * Drain the flushes queued for @cpu by tlb_flush_queue_remote.
+ */
+static void tlb_flush_pending_async_work(CPUState *cpu, run_on_cpu_data data)
+{
+    CPUTLBCommon *c = &cpu->neg.tlb.c;
+    CPUTLBPendingFlush pending[CPU_TLB_PENDING_SIZE];
+    uint16_t full, count, i;
+
+    assert_cpu_is_self(cpu);
+
+    qemu_spin_lock(&c->lock);
+    full = c->pending_full;
+    count = c->pending_count;
+    memcpy(pending, c->pending, count * sizeof(pending[0]));
+    c->pending_full = 0;
+    c->pending_count = 0;
+    c->pending_queued = false;
+    qemu_spin_unlock(&c->lock);
+
+    if (full) {
+        tlb_flush_by_mmuidx_async_work(cpu, RUN_ON_CPU_HOST_INT(full));
+    }
+    for (i = 0; i < count; i++) {
+        uint16_t idxmap = pending[i].idxmap & ~full;
+
+        if (!idxmap) {
+            continue;
+        }
+        if (pending[i].bits) {
+            TLBFlushRangeData d = {
+                .addr = pending[i].addr,
+                .len = pending[i].len,
+                .idxmap = idxmap,
+                .bits = pending[i].bits,
+            };
+            tlb_flush_range_by_mmuidx_async_0(cpu, d);
+        } else {
+            tlb_flush_page_by_mmuidx_async_0(cpu, pending[i].addr, idxmap);
+        }
+    }
+}
+
 void tlb_flush_range_by_mmuidx(CPUState *cpu, vaddr addr,
                                vaddr len, uint16_t idxmap,
                                unsigned bits)
@@ -804,7 +946,7 @@ void tlb_flush_range_by_mmuidx_all_cpus_synced(CPUState *src_cpu,
                                                unsigned bits)
 {
     TLBFlushRangeData d, *p;
-    CPUState *dst_cpu;
+    CPUTLBPendingFlush req;
 
     /*
      * If all bits are significant, and len is small,
@@ -826,14 +968,13 @@ void tlb_flush_range_by_mmuidx_all_cpus_synced(CPUState *src_cpu,
     d.idxmap = idxmap;
     d.bits = bits;
 
-    /* Allocate a separate data block for each destination cpu.  */
-    CPU_FOREACH(dst_cpu) {
-        if (dst_cpu != src_cpu) {
-            p = g_memdup(&d, sizeof(d));
-            async_run_on_cpu(dst_cpu, tlb_flush_range_by_mmuidx_async_1,
-                             RUN_ON_CPU_HOST_PTR(p));
-        }
-    }
+    req = (CPUTLBPendingFlush) {
+        .addr = d.addr,
+        .len = len,
+        .idxmap = idxmap,
+        .bits = bits,
+    };
+    tlb_flush_queue_all_remote(src_cpu, &req, false);
 
     p = g_memdup(&d, sizeof(d));
     async_safe_run_on_cpu(src_cpu, tlb_flush_range_by_mmuidx_async_1,
@@ -2315,6 +2456,40 @@ static uint64_t do_ld_8(CPUState *cpu, MMULookupPageData *p, int mmu_idx,
     return ret;
 }
 
+/*
+ * For a load crossing into a second page of RAM, when no subobject of the
+ * access requires atomicity, gather the bytes from both pages and load the
+ * value as a whole, instead of accumulating it byte by byte.
+ * Return false if the access needs the generic treatment.
+ */
+static bool do_ld_crosspage_ram(MMULookupLocals *l, uint64_t *ret)
+{
+    int size0 = l->page[0].size;
+    int size1 = l->page[1].size;
+    uint8_t buf[8];
+
+    switch (l->memop & MO_ATOM_MASK) {
+    case MO_ATOM_IFALIGN:
+    case MO_ATOM_WITHIN16:
+    case MO_ATOM_NONE:
+        break;
+    default:
+        return false;
+    }
+    if (unlikely((l->page[0].flags | l->page[1].flags) & TLB_MMIO)) {
+        return false;
+    }
+
+    memcpy(buf, l->page[0].haddr, size0);
+    memcpy(buf + size0, l->page[1].haddr, size1);
+    if ((l->memop & MO_BSWAP) == MO_LE) {
+        *ret = ldn_le_p(buf, size0 + size1);
+    } else {
+        *ret = ldn_be_p(buf, size0 + size1);
+    }
+    return true;
+}
+
 static uint8_t do_ld1_mmu(CPUState *cpu, vaddr addr, MemOpIdx oi,
                           uintptr_t ra, MMUAccessType access_type)
 {
@@ -2358,6 +2533,7 @@ static uint32_t do_ld4_mmu(CPUState *cpu, vaddr addr, MemOpIdx oi,
 {
     MMULookupLocals l;
     bool crosspage;
+    uint64_t val;
     uint32_t ret;
 
     cpu_req_mo(TCG_MO_LD_LD | TCG_MO_ST_LD);
@@ -2365,6 +2541,9 @@ static uint32_t do_ld4_mmu(CPUState *cpu, vaddr addr, MemOpIdx oi,
     if (likely(!crosspage)) {
         return do_ld_4(cpu, &l.page[0], l.mmu_idx, access_type, l.memop, ra);
     }
+    if (do_ld_crosspage_ram(&l, &val)) {
+        return val;
+    }
 
     ret = do_ld_beN(cpu, &l.page[0], 0, l.mmu_idx, access_type, l.memop, ra);
     ret = do_ld_beN(cpu, &l.page[1], ret, l.mmu_idx, access_type, l.memop, ra);
@@ -2386,6 +2565,9 @@ static uint64_t do_ld8_mmu(CPUState *cpu, vaddr addr, MemOpIdx oi,
     if (likely(!crosspage)) {
         return do_ld_8(cpu, &l.page[0], l.mmu_idx, access_type, l.memop, ra);
     }
+    if (do_ld_crosspage_ram(&l, &ret)) {
+        return ret;
+    }
 
     ret = do_ld_beN(cpu, &l.page[0], 0, l.mmu_idx, access_type, l.memop, ra);
     ret = do_ld_beN(cpu, &l.page[1], ret, l.mmu_idx, access_type, l.memop, ra);
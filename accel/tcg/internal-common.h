@@ -16,6 +16,7 @@ extern int64_t max_delay;
 extern int64_t max_advance;
 
 extern bool one_insn_per_tb;
+extern bool tcg_jmp_cache_stats;
 
 extern bool icount_align_option;
 
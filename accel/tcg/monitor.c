@@ -12,12 +12,15 @@
 #include "qapi/error.h"
 #include "qapi/type-helpers.h"
 #include "qapi/qapi-commands-machine.h"
+#include "qapi/qapi-types-stats.h"
 #include "monitor/monitor.h"
 #include "system/cpu-timers.h"
+#include "system/stats.h"
 #include "system/tcg.h"
 #include "tcg/tcg.h"
 #include "internal-common.h"
 #include "tb-context.h"
+#include "tb-jmp-cache.h"
 
 
 static void dump_drift_info(GString *buf)
@@ -99,6 +102,7 @@ struct tb_tree_stats {
     size_t max_target_size;
     size_t direct_jmp_count;
     size_t direct_jmp2_count;
+    size_t chained_jmp_count;
     size_t cross_page;
 };
 
@@ -122,22 +126,53 @@ static gboolean tb_tree_stats_iter(gpointer key, gpointer value, gpointer data)
             tst->direct_jmp2_count++;
         }
     }
+    for (int n = 0; n < 2; n++) {
+        /* The LSB tags a jump that can no longer be patched. */
+        if (qatomic_read(&tb->jmp_dest[n]) & ~(uintptr_t)1) {
+            tst->chained_jmp_count++;
+        }
+    }
     return false;
 }
 
-static void tlb_flush_counts(size_t *pfull, size_t *ppart, size_t *pelide)
+static void tlb_flush_counts(size_t *pfull, size_t *ppart, size_t *pelide,
+                             size_t *pcoalesce)
 {
     CPUState *cpu;
-    size_t full = 0, part = 0, elide = 0;
+    size_t full = 0, part = 0, elide = 0, coalesce = 0;
 
     CPU_FOREACH(cpu) {
         full += qatomic_read(&cpu->neg.tlb.c.full_flush_count);
         part += qatomic_read(&cpu->neg.tlb.c.part_flush_count);
         elide += qatomic_read(&cpu->neg.tlb.c.elide_flush_count);
+        coalesce += qatomic_read(&cpu->neg.tlb.c.coalesced_flush_count);
     }
     *pfull = full;
     *ppart = part;
     *pelide = elide;
+    *pcoalesce = coalesce;
+}
+
+static void tb_jmp_cache_counts(size_t *phit, size_t *pmiss,
+                                size_t *plookup, size_t *pexit)
+{
+    CPUState *cpu;
+    size_t hit = 0, miss = 0, lookup = 0, exited = 0;
+
+    CPU_FOREACH(cpu) {
+        CPUJumpCache *jc = cpu->tb_jmp_cache;
+
+        if (jc) {
+            hit += qatomic_read(&jc->hit_count);
+            miss += qatomic_read(&jc->miss_count);
+            lookup += qatomic_read(&jc->ptr_lookup_count);
+            exited += qatomic_read(&jc->ptr_exit_count);
+        }
+    }
+    *phit = hit;
+    *pmiss = miss;
+    *plookup = lookup;
+    *pexit = exited;
 }
 
 static void tcg_dump_info(GString *buf)
@@ -150,6 +185,7 @@ static void dump_exec_info(GString *buf)
     struct tb_tree_stats tst = {};
     struct qht_stats hst;
     size_t nb_tbs, flush_full, flush_part, flush_elide;
+    size_t flush_coalesce, jc_hit, jc_miss, ptr_lookup, ptr_exit;
 
     tcg_tb_foreach(tb_tree_stats_iter, &tst);
     nb_tbs = tst.nb_tbs;
@@ -180,21 +216,51 @@ static void dump_exec_info(GString *buf)
                            nb_tbs ? (tst.direct_jmp_count * 100) / nb_tbs : 0,
                            tst.direct_jmp2_count,
                            nb_tbs ? (tst.direct_jmp2_count * 100) / nb_tbs : 0);
+    g_string_append_printf(buf, "chained jump count  %zu (%zu%% of direct)\n",
+                           tst.chained_jmp_count,
+                           tst.direct_jmp_count + tst.direct_jmp2_count ?
+                           (tst.chained_jmp_count * 100) /
+                           (tst.direct_jmp_count + tst.direct_jmp2_count) : 0);
 
     qht_statistics_init(&tb_ctx.htable, &hst);
     print_qht_statistics(hst, buf);
     qht_statistics_destroy(&hst);
 
     g_string_append_printf(buf, "\nStatistics:\n");
+    g_string_append_printf(buf, "TB translate count  %u (%u discarded)\n",
+                           qatomic_read(&tb_ctx.tb_gen_count),
+                           qatomic_read(&tb_ctx.tb_gen_discard_count));
     g_string_append_printf(buf, "TB flush count      %u\n",
                            qatomic_read(&tb_ctx.tb_flush_count));
+    g_string_append_printf(buf, "TB flush time       %" PRIu64 " us "
+                           "(max %" PRIu64 " us)\n",
+                           qatomic_read_u64(&tb_ctx.tb_flush_time_ns) / 1000,
+                           qatomic_read_u64(&tb_ctx.tb_flush_max_ns) / 1000);
     g_string_append_printf(buf, "TB invalidate count %u\n",
                            qatomic_read(&tb_ctx.tb_phys_invalidate_count));
+    g_string_append_printf(buf, "helper call spills  %zu\n",
+                           tcg_call_spill_count());
+
+    tb_jmp_cache_counts(&jc_hit, &jc_miss, &ptr_lookup, &ptr_exit);
+    if (qatomic_read(&tcg_jmp_cache_stats)) {
+        g_string_append_printf(buf, "TB jmp cache hits   %zu (%zu%%)\n",
+                               jc_hit, jc_hit + jc_miss ?
+                               (jc_hit * 100) / (jc_hit + jc_miss) : 0);
+    }
+    g_string_append_printf(buf, "TB jmp cache misses %zu\n", jc_miss);
+    if (qatomic_read(&tcg_jmp_cache_stats)) {
+        g_string_append_printf(buf, "indirect lookups    %zu (%zu%% exited)\n",
+                               ptr_lookup,
+                               ptr_lookup ? (ptr_exit * 100) / ptr_lookup : 0);
+    } else {
+        g_string_append_printf(buf, "indirect exits      %zu\n", ptr_exit);
+    }
 
-    tlb_flush_counts(&flush_full, &flush_part, &flush_elide);
+    tlb_flush_counts(&flush_full, &flush_part, &flush_elide, &flush_coalesce);
     g_string_append_printf(buf, "TLB full flushes    %zu\n", flush_full);
     g_string_append_printf(buf, "TLB partial flushes %zu\n", flush_part);
     g_string_append_printf(buf, "TLB elided flushes  %zu\n", flush_elide);
+    g_string_append_printf(buf, "TLB merged flushes  %zu\n", flush_coalesce);
     tcg_dump_info(buf);
 }
 
@@ -234,10 +300,172 @@ HumanReadableText *qmp_x_query_opcount(Error **errp)
     return human_readable_text_from_str(buf);
 }
 
+/*
+ * query-stats support.  All TCG statistics are VM-wide; the values
+ * are the same ones reported by "info jit".
+ */
+enum {
+    TCG_STAT_TB_TRANSLATIONS,
+    TCG_STAT_TB_DISCARDS,
+    TCG_STAT_TB_FLUSHES,
+    TCG_STAT_TB_FLUSH_TIME,
+    TCG_STAT_TB_FLUSH_MAX_TIME,
+    TCG_STAT_TB_INVALIDATIONS,
+    TCG_STAT_CODE_SIZE,
+    TCG_STAT_HELPER_CALL_SPILLS,
+    TCG_STAT_JMP_CACHE_HITS,
+    TCG_STAT_JMP_CACHE_MISSES,
+    TCG_STAT_INDIRECT_LOOKUPS,
+    TCG_STAT_INDIRECT_EXITS,
+    TCG_STAT_TLB_FULL_FLUSHES,
+    TCG_STAT_TLB_PARTIAL_FLUSHES,
+    TCG_STAT_TLB_ELIDED_FLUSHES,
+    TCG_STAT_TLB_MERGED_FLUSHES,
+    TCG_STAT__MAX,
+};
+
+typedef struct TCGStatsDesc {
+    const char *name;
+    StatsType type;
+    int16_t exponent;   /* unit is 10^exponent seconds; 0 for counters */
+    bool needs_jmp_cache_stats;
+} TCGStatsDesc;
+
+static const TCGStatsDesc tcg_stats_desc[TCG_STAT__MAX] = {
+    [TCG_STAT_TB_TRANSLATIONS] = { "tb-translations", STATS_TYPE_CUMULATIVE },
+    [TCG_STAT_TB_DISCARDS] = { "tb-discards", STATS_TYPE_CUMULATIVE },
+    [TCG_STAT_TB_FLUSHES] = { "tb-flushes", STATS_TYPE_CUMULATIVE },
+    [TCG_STAT_TB_FLUSH_TIME] = { "tb-flush-time", STATS_TYPE_CUMULATIVE, -9 },
+    [TCG_STAT_TB_FLUSH_MAX_TIME] = { "tb-flush-max-time", STATS_TYPE_PEAK, -9 },
+    [TCG_STAT_TB_INVALIDATIONS] = { "tb-invalidations",
+                                    STATS_TYPE_CUMULATIVE },
+    [TCG_STAT_CODE_SIZE] = { "code-size", STATS_TYPE_INSTANT },
+    [TCG_STAT_HELPER_CALL_SPILLS] = { "helper-call-spills",
+                                      STATS_TYPE_CUMULATIVE },
+    [TCG_STAT_JMP_CACHE_HITS] = { "jmp-cache-hits", STATS_TYPE_CUMULATIVE,
+                                  0, true },
+    [TCG_STAT_JMP_CACHE_MISSES] = { "jmp-cache-misses",
+                                    STATS_TYPE_CUMULATIVE },
+    [TCG_STAT_INDIRECT_LOOKUPS] = { "indirect-lookups", STATS_TYPE_CUMULATIVE,
+                                    0, true },
+    [TCG_STAT_INDIRECT_EXITS] = { "indirect-exits", STATS_TYPE_CUMULATIVE },
+    [TCG_STAT_TLB_FULL_FLUSHES] = { "tlb-full-flushes",
+                                    STATS_TYPE_CUMULATIVE },
+    [TCG_STAT_TLB_PARTIAL_FLUSHES] = { "tlb-partial-flushes",
+                                       STATS_TYPE_CUMULATIVE },
+    [TCG_STAT_TLB_ELIDED_FLUSHES] = { "tlb-elided-flushes",
+                                      STATS_TYPE_CUMULATIVE },
+    [TCG_STAT_TLB_MERGED_FLUSHES] = { "tlb-merged-flushes",
+                                      STATS_TYPE_CUMULATIVE },
+};
+
+/* Fill @val, indexed by TCG_STAT_*, walking the CPU list only once each */
+static void tcg_stats_collect(uint64_t val[TCG_STAT__MAX])
+{
+    size_t hit, miss, lookup, exited;
+    size_t full, part, elide, coalesce;
+
+    tb_jmp_cache_counts(&hit, &miss, &lookup, &exited);
+    tlb_flush_counts(&full, &part, &elide, &coalesce);
+
+    val[TCG_STAT_TB_TRANSLATIONS] = qatomic_read(&tb_ctx.tb_gen_count);
+    val[TCG_STAT_TB_DISCARDS] = qatomic_read(&tb_ctx.tb_gen_discard_count);
+    val[TCG_STAT_TB_FLUSHES] = qatomic_read(&tb_ctx.tb_flush_count);
+    val[TCG_STAT_TB_FLUSH_TIME] = qatomic_read_u64(&tb_ctx.tb_flush_time_ns);
+    val[TCG_STAT_TB_FLUSH_MAX_TIME] = qatomic_read_u64(&tb_ctx.tb_flush_max_ns);
+    val[TCG_STAT_TB_INVALIDATIONS] =
+        qatomic_read(&tb_ctx.tb_phys_invalidate_count);
+    val[TCG_STAT_CODE_SIZE] = tcg_code_size();
+    val[TCG_STAT_HELPER_CALL_SPILLS] = tcg_call_spill_count();
+    val[TCG_STAT_JMP_CACHE_HITS] = hit;
+    val[TCG_STAT_JMP_CACHE_MISSES] = miss;
+    val[TCG_STAT_INDIRECT_LOOKUPS] = lookup;
+    val[TCG_STAT_INDIRECT_EXITS] = exited;
+    val[TCG_STAT_TLB_FULL_FLUSHES] = full;
+    val[TCG_STAT_TLB_PARTIAL_FLUSHES] = part;
+    val[TCG_STAT_TLB_ELIDED_FLUSHES] = elide;
+    val[TCG_STAT_TLB_MERGED_FLUSHES] = coalesce;
+}
+
+static void tcg_query_stats_cb(StatsResultList **result, StatsTarget target,
+                               strList *names, strList *targets, Error **errp)
+{
+    uint64_t val[TCG_STAT__MAX];
+    StatsList *stats_list = NULL;
+    bool jmp_cache_stats;
+    int i;
+
+    if (!tcg_enabled() || target != STATS_TARGET_VM) {
+        return;
+    }
+
+    tcg_stats_collect(val);
+    jmp_cache_stats = qatomic_read(&tcg_jmp_cache_stats);
+
+    for (i = TCG_STAT__MAX - 1; i >= 0; i--) {
+        const TCGStatsDesc *desc = &tcg_stats_desc[i];
+        Stats *stats;
+
+        if (desc->needs_jmp_cache_stats && !jmp_cache_stats) {
+            continue;
+        }
+        if (!apply_str_list_filter(desc->name, names)) {
+            continue;
+        }
+        stats = g_new0(Stats, 1);
+        stats->name = g_strdup(desc->name);
+        stats->value = g_new0(StatsValue, 1);
+        stats->value->type = QTYPE_QNUM;
+        stats->value->u.scalar = val[i];
+        QAPI_LIST_PREPEND(stats_list, stats);
+    }
+
+    if (stats_list) {
+        add_stats_entry(result, STATS_PROVIDER_TCG, NULL, stats_list);
+    }
+}
+
+static void tcg_query_stats_schemas_cb(StatsSchemaList **result, Error **errp)
+{
+    StatsSchemaValueList *stats_list = NULL;
+    bool jmp_cache_stats;
+    int i;
+
+    if (!tcg_enabled()) {
+        return;
+    }
+
+    jmp_cache_stats = qatomic_read(&tcg_jmp_cache_stats);
+
+    for (i = TCG_STAT__MAX - 1; i >= 0; i--) {
+        const TCGStatsDesc *desc = &tcg_stats_desc[i];
+        StatsSchemaValue *schema;
+
+        if (desc->needs_jmp_cache_stats && !jmp_cache_stats) {
+            continue;
+        }
+        schema = g_new0(StatsSchemaValue, 1);
+        schema->name = g_strdup(desc->name);
+        schema->type = desc->type;
+        if (desc->exponent) {
+            schema->has_unit = true;
+            schema->unit = STATS_UNIT_SECONDS;
+            schema->has_base = true;
+            schema->base = 10;
+            schema->exponent = desc->exponent;
+        }
+        QAPI_LIST_PREPEND(stats_list, schema);
+    }
+
+    add_stats_schema(result, STATS_PROVIDER_TCG, STATS_TARGET_VM, stats_list);
+}
+
 static void hmp_tcg_register(void)
 {
     monitor_register_hmp_info_hrt("jit", qmp_x_query_jit);
     monitor_register_hmp_info_hrt("opcount", qmp_x_query_opcount);
+    add_stats_callbacks(STATS_PROVIDER_TCG, tcg_query_stats_cb,
+                        tcg_query_stats_schemas_cb);
 }
 
 type_init(hmp_tcg_register);
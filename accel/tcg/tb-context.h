@@ -35,6 +35,10 @@ struct TBContext {
     /* statistics */
     unsigned tb_flush_count;
     unsigned tb_phys_invalidate_count;
+    unsigned tb_gen_count;
+    unsigned tb_gen_discard_count;
+    uint64_t tb_flush_time_ns;
+    uint64_t tb_flush_max_ns;
 };
 
 extern TBContext tb_ctx;
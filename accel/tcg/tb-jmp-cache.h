@@ -21,6 +21,11 @@
  * no need for qatomic_rcu_read() and pc is always consistent with a
  * non-NULL value of 'tb'.  Strictly speaking pc is only needed for
  * CF_PCREL, but it's used always for simplicity.
+ *
+ * The cache is 2-way set associative: the hash with its least significant
+ * bit cleared selects a pair of adjacent entries.  Since both entries of
+ * a set share the same page bits of the hash, tb_jmp_cache_clear_page()
+ * keeps working on a contiguous range.
  */
 typedef struct CPUJumpCache {
     struct rcu_head rcu;
@@ -28,6 +33,37 @@ typedef struct CPUJumpCache {
         TranslationBlock *tb;
         vaddr pc;
     } array[TB_JMP_CACHE_SIZE];
+    /*
+     * Statistics, written only by the owning CPU.  Misses and exits are
+     * counted on the slow path; hits and indirect lookups only with
+     * "-accel tcg,jmp-cache-stats=on".
+     */
+    size_t hit_count;
+    size_t miss_count;
+    size_t ptr_lookup_count;    /* helper_lookup_tb_ptr calls */
+    size_t ptr_exit_count;      /* ... that returned to the epilogue */
 } CPUJumpCache;
 
+static inline unsigned int tb_jmp_cache_set(unsigned int hash)
+{
+    return hash & ~1u;
+}
+
+/*
+ * Insert @tb as the most recent entry of the set for @hash, demoting the
+ * previous most recent entry and dropping the least recent one.
+ * A concurrently invalidated TB may survive the demotion, but it carries
+ * CF_INVALID and therefore can never match a lookup.
+ */
+static inline void tb_jmp_cache_insert(CPUJumpCache *jc, unsigned int hash,
+                                       vaddr pc, TranslationBlock *tb)
+{
+    unsigned int set = tb_jmp_cache_set(hash);
+
+    jc->array[set + 1].pc = jc->array[set].pc;
+    qatomic_set(&jc->array[set + 1].tb, qatomic_read(&jc->array[set].tb));
+    jc->array[set].pc = pc;
+    qatomic_set(&jc->array[set].tb, tb);
+}
+
 #endif /* ACCEL_TCG_TB_JMP_CACHE_H */
@@ -20,6 +20,7 @@
 #include "qemu/osdep.h"
 #include "qemu/interval-tree.h"
 #include "qemu/qtree.h"
+#include "qemu/timer.h"
 #include "exec/cputlb.h"
 #include "exec/log.h"
 #include "exec/exec-all.h"
@@ -187,8 +188,48 @@ struct PageDesc {
     QemuSpin lock;
     /* list of TBs intersecting this ram page */
     uintptr_t first_tb;
+    /*
+     * One bit per 1/64th of the page, set for each granule covered by a
+     * TB in first_tb.  Bits are only cleared once first_tb is empty, so
+     * this is a superset of the code on the page; it may be read without
+     * the lock to filter out writes that cannot hit any code.
+     */
+    uint64_t code_bitmap;
 };
 
+#define PAGE_CODE_GRANULE_BITS  (TARGET_PAGE_BITS - 6)
+
+/*
+ * Return the first and last address of the part of @tb that lives on
+ * page @n of the TB.
+ */
+static void tb_page_extent(const TranslationBlock *tb, int n,
+                           tb_page_addr_t *pstart, tb_page_addr_t *plast)
+{
+    tb_page_addr_t tb_start, tb_last;
+
+    /* NOTE: this is subtle as a TB may span two physical pages */
+    tb_start = tb_page_addr0(tb);
+    tb_last = tb_start + tb->size - 1;
+    if (n == 0) {
+        tb_last = MIN(tb_last, tb_start | ~TARGET_PAGE_MASK);
+    } else {
+        tb_start = tb_page_addr1(tb);
+        tb_last = tb_start + (tb_last & ~TARGET_PAGE_MASK);
+    }
+    *pstart = tb_start;
+    *plast = tb_last;
+}
+
+/* Return the code_bitmap bits for [@start, @last] within one page. */
+static uint64_t page_code_mask(tb_page_addr_t start, tb_page_addr_t last)
+{
+    unsigned first = (start & ~TARGET_PAGE_MASK) >> PAGE_CODE_GRANULE_BITS;
+    unsigned final = (last & ~TARGET_PAGE_MASK) >> PAGE_CODE_GRANULE_BITS;
+
+    return MAKE_64BIT_MASK(first, final - first + 1);
+}
+
 void page_table_config_init(void)
 {
     uint32_t v_l1_bits;
@@ -668,6 +709,7 @@ static void tb_remove_all_1(int level, void **lp)
         for (i = 0; i < V_L2_SIZE; ++i) {
             page_lock(&pd[i]);
             pd[i].first_tb = (uintptr_t)NULL;
+            qatomic_set(&pd[i].code_bitmap, 0);
             page_unlock(&pd[i]);
         }
     } else {
@@ -695,6 +737,7 @@ static void tb_remove_all(void)
 static void tb_page_add(PageDesc *p, TranslationBlock *tb, unsigned int n)
 {
     bool page_already_protected;
+    tb_page_addr_t start, last;
 
     assert_page_locked(p);
 
@@ -702,6 +745,9 @@ static void tb_page_add(PageDesc *p, TranslationBlock *tb, unsigned int n)
     page_already_protected = p->first_tb != 0;
     p->first_tb = (uintptr_t)tb | n;
 
+    tb_page_extent(tb, n, &start, &last);
+    qatomic_set(&p->code_bitmap, p->code_bitmap | page_code_mask(start, last));
+
     /*
      * If some code is already present, then the pages are already
      * protected. So we handle the case where only the first TB is
@@ -737,6 +783,9 @@ static void tb_page_remove(PageDesc *pd, TranslationBlock *tb)
     PAGE_FOR_EACH_TB(unused, unused, pd, tb1, n1) {
         if (tb1 == tb) {
             *pprev = tb1->page_next[n1];
+            if (!pd->first_tb) {
+                qatomic_set(&pd->code_bitmap, 0);
+            }
             return;
         }
         pprev = &tb1->page_next[n1];
@@ -763,6 +812,7 @@ static void tb_remove(TranslationBlock *tb)
 static void do_tb_flush(CPUState *cpu, run_on_cpu_data tb_flush_count)
 {
     bool did_flush = false;
+    int64_t start, delta;
 
     mmap_lock();
     /* If it is already been done on request of another CPU, just retry. */
@@ -770,18 +820,31 @@ static void do_tb_flush(CPUState *cpu, run_on_cpu_data tb_flush_count)
         goto done;
     }
     did_flush = true;
+    start = get_clock();
 
     CPU_FOREACH(cpu) {
         tcg_flush_jmp_cache(cpu);
     }
 
-    qht_reset_size(&tb_ctx.htable, CODE_GEN_HTABLE_SIZE);
+    /*
+     * Keep the hash table at its current size: the code buffer is usually
+     * refilled with about as many TBs as before, and growing the table
+     * again would rehash it under all bucket locks a few more times.
+     */
+    qht_reset(&tb_ctx.htable);
     tb_remove_all();
 
     tcg_region_reset_all();
     /* XXX: flush processor icache at this point if cache flush is expensive */
     qatomic_inc(&tb_ctx.tb_flush_count);
 
+    /* Account the stall; all vCPUs are stopped while we are in here. */
+    delta = get_clock() - start;
+    qatomic_set_u64(&tb_ctx.tb_flush_time_ns, tb_ctx.tb_flush_time_ns + delta);
+    if (delta > tb_ctx.tb_flush_max_ns) {
+        qatomic_set_u64(&tb_ctx.tb_flush_max_ns, delta);
+    }
+
 done:
     mmap_unlock();
     if (did_flush) {
@@ -889,13 +952,15 @@ static void tb_jmp_cache_inval_tb(TranslationBlock *tb)
             tcg_flush_jmp_cache(cpu);
         }
     } else {
-        uint32_t h = tb_jmp_cache_hash_func(tb->pc);
+        uint32_t set = tb_jmp_cache_set(tb_jmp_cache_hash_func(tb->pc));
 
         CPU_FOREACH(cpu) {
             CPUJumpCache *jc = cpu->tb_jmp_cache;
 
-            if (qatomic_read(&jc->array[h].tb) == tb) {
-                qatomic_set(&jc->array[h].tb, NULL);
+            for (int i = 0; i < 2; i++) {
+                if (qatomic_read(&jc->array[set + i].tb) == tb) {
+                    qatomic_set(&jc->array[set + i].tb, NULL);
+                }
             }
         }
     }
@@ -1094,6 +1159,19 @@ bool tb_invalidate_phys_page_unwind(tb_page_addr_t addr, uintptr_t pc)
     return false;
 }
 #else
+/*
+ * Return true if the part of @tb that lives on page @n of the TB
+ * intersects [@start, @last], which must lie within that page.
+ */
+static bool tb_intersects_page_range(const TranslationBlock *tb, int n,
+                                     tb_page_addr_t start, tb_page_addr_t last)
+{
+    tb_page_addr_t tb_start, tb_last;
+
+    tb_page_extent(tb, n, &tb_start, &tb_last);
+    return !(tb_last < start || tb_start > last);
+}
+
 /*
  * @p must be non-NULL.
  * Call with all @pages locked.
@@ -1119,18 +1197,7 @@ tb_invalidate_phys_page_range__locked(struct page_collection *pages,
      * XXX: see if in some cases it could be faster to invalidate all the code
      */
     PAGE_FOR_EACH_TB(start, last, p, tb, n) {
-        tb_page_addr_t tb_start, tb_last;
-
-        /* NOTE: this is subtle as a TB may span two physical pages */
-        tb_start = tb_page_addr0(tb);
-        tb_last = tb_start + tb->size - 1;
-        if (n == 0) {
-            tb_last = MIN(tb_last, tb_start | ~TARGET_PAGE_MASK);
-        } else {
-            tb_start = tb_page_addr1(tb);
-            tb_last = tb_start + (tb_last & ~TARGET_PAGE_MASK);
-        }
-        if (!(tb_last < start || tb_start > last)) {
+        if (tb_intersects_page_range(tb, n, start, last)) {
 #ifdef TARGET_HAS_PRECISE_SMC
             if (current_tb == tb &&
                 (tb_cflags(current_tb) & CF_COUNT_MASK) != 1) {
@@ -1225,8 +1292,46 @@ void tb_invalidate_phys_range_fast(ram_addr_t ram_addr,
                                    uintptr_t retaddr)
 {
     struct page_collection *pages;
+    tb_page_addr_t last = ram_addr + size - 1;
+    TranslationBlock *tb;
+    PageForEachNext n;
+    PageDesc *pd;
+    bool hit = false;
+
+    pd = page_find(ram_addr >> TARGET_PAGE_BITS);
+    if (pd == NULL) {
+        return;
+    }
+
+    /* Writes to granules without any code do not even need the lock. */
+    if (qatomic_read(&pd->first_tb) &&
+        !(qatomic_read(&pd->code_bitmap) & page_code_mask(ram_addr, last))) {
+        return;
+    }
+
+    /*
+     * Most writes to a page with code hit data that merely shares the page.
+     * Check for that with only this page locked, before building a page
+     * collection that would also lock the pages of every TB on it.
+     */
+    page_lock(pd);
+    if (pd->first_tb) {
+        PAGE_FOR_EACH_TB(ram_addr, last, pd, tb, n) {
+            if (tb_intersects_page_range(tb, n, ram_addr, last)) {
+                hit = true;
+                break;
+            }
+        }
+    } else {
+        /* No code left: let the slow path drop the write protection. */
+        hit = true;
+    }
+    page_unlock(pd);
+    if (!hit) {
+        return;
+    }
 
-    pages = page_collection_lock(ram_addr, ram_addr + size - 1);
+    pages = page_collection_lock(ram_addr, last);
     tb_invalidate_phys_page_fast__locked(pages, ram_addr, size, retaddr);
     page_collection_unlock(pages);
 }
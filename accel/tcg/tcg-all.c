@@ -48,6 +48,7 @@ struct TCGState {
 
     bool mttcg_enabled;
     bool one_insn_per_tb;
+    bool jmp_cache_stats;
     int splitwx_enabled;
     unsigned long tb_size;
 };
@@ -102,6 +103,7 @@ static void tcg_accel_instance_init(Object *obj)
 
 bool mttcg_enabled;
 bool one_insn_per_tb;
+bool tcg_jmp_cache_stats;
 
 static int tcg_init_machine(MachineState *ms)
 {
@@ -212,6 +214,19 @@ static void tcg_set_one_insn_per_tb(Object *obj, bool value, Error **errp)
     qatomic_set(&one_insn_per_tb, value);
 }
 
+static bool tcg_get_jmp_cache_stats(Object *obj, Error **errp)
+{
+    TCGState *s = TCG_STATE(obj);
+    return s->jmp_cache_stats;
+}
+
+static void tcg_set_jmp_cache_stats(Object *obj, bool value, Error **errp)
+{
+    TCGState *s = TCG_STATE(obj);
+    s->jmp_cache_stats = value;
+    qatomic_set(&tcg_jmp_cache_stats, value);
+}
+
 static int tcg_gdbstub_supported_sstep_flags(void)
 {
     /*
@@ -257,6 +272,12 @@ static void tcg_accel_class_init(ObjectClass *oc, void *data)
                                    tcg_set_one_insn_per_tb);
     object_class_property_set_description(oc, "one-insn-per-tb",
         "Only put one guest insn in each translation block");
+
+    object_class_property_add_bool(oc, "jmp-cache-stats",
+                                   tcg_get_jmp_cache_stats,
+                                   tcg_set_jmp_cache_stats);
+    object_class_property_set_description(oc, "jmp-cache-stats",
+        "Count TB jump cache hits for info jit and query-stats");
 }
 
 static const TypeInfo tcg_accel_type = {
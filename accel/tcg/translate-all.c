@@ -430,6 +430,7 @@ TranslationBlock *tb_gen_code(CPUState *cpu,
         goto buffer_overflow;
     }
     tb->tc.size = gen_code_size;
+    qatomic_inc(&tb_ctx.tb_gen_count);
 
     /*
      * For CF_PCREL, attribute all executions of the generated code
@@ -570,6 +571,7 @@ TranslationBlock *tb_gen_code(CPUState *cpu,
         orig_aligned -= ROUND_UP(sizeof(*tb), qemu_icache_linesize);
         qatomic_set(&tcg_ctx->code_gen_ptr, (void *)orig_aligned);
         tcg_tb_remove(tb);
+        qatomic_inc(&tb_ctx.tb_gen_discard_count);
         return existing_tb;
     }
     return tb;
@@ -35,6 +35,7 @@
 #define BLOCK_COPY_MAX_WORKERS 64
 #define BLOCK_COPY_SLICE_TIME 100000000ULL /* ns */
 #define BLOCK_COPY_CLUSTER_SIZE_DEFAULT (1 << 16)
+#define BLOCK_COPY_ADAPTIVE_START_WORKERS 4
 
 typedef enum {
     COPY_READ_WRITE_CLUSTER,
@@ -53,6 +54,7 @@ typedef struct BlockCopyCallState {
     int64_t bytes;
     int max_workers;
     int64_t max_chunk;
+    bool adaptive_workers;
     bool ignore_ratelimit;
     BlockCopyAsyncCallbackFunc cb;
     void *cb_opaque;
@@ -66,6 +68,16 @@ typedef struct BlockCopyCallState {
     /* To reference all call states from BlockCopyState */
     QLIST_ENTRY(BlockCopyCallState) list;
 
+    /*
+     * Worker count controller for @adaptive_workers, only touched by the
+     * coroutine running block_copy_dirty_clusters().
+     */
+    int workers;
+    int workers_step;
+    int64_t window_start_ns;
+    uint64_t window_start_bytes;
+    uint64_t last_throughput;
+
     /*
      * Fields that report information about return values and errors.
      * Protected by lock in BlockCopyState.
@@ -78,6 +90,8 @@ typedef struct BlockCopyCallState {
      * anymore and may be safely read without mutex.
      */
     int ret;
+    /* Bytes successfully copied by this call, protected by lock */
+    uint64_t bytes_copied;
 } BlockCopyCallState;
 
 typedef struct BlockCopyTask {
@@ -601,8 +615,11 @@ static coroutine_fn int block_copy_task_entry(AioTask *task)
                 t->call_state->ret = ret;
                 t->call_state->error_is_read = error_is_read;
             }
-        } else if (s->progress) {
-            progress_work_done(s->progress, t->req.bytes);
+        } else {
+            t->call_state->bytes_copied += t->req.bytes;
+            if (s->progress) {
+                progress_work_done(s->progress, t->req.bytes);
+            }
         }
     }
     co_put_to_shres(s->mem, t->req.bytes);
@@ -736,6 +753,57 @@ int64_t coroutine_fn block_copy_reset_unallocated(BlockCopyState *s,
     return ret;
 }
 
+/*
+ * Hill-climb the number of parallel requests on observed throughput: once
+ * per slice, keep moving the worker count in the same direction as long as
+ * throughput does not drop, and turn around when it does.  This finds the
+ * knee where the target stops scaling with queue depth instead of always
+ * keeping max_workers requests in flight.
+ */
+static void coroutine_fn
+block_copy_adapt_workers(BlockCopyCallState *call_state, AioTaskPool *aio)
+{
+    BlockCopyState *s = call_state->s;
+    int64_t now = qemu_clock_get_ns(QEMU_CLOCK_REALTIME);
+    int64_t elapsed = now - call_state->window_start_ns;
+    uint64_t bytes_copied, throughput;
+    int step;
+
+    if (elapsed < BLOCK_COPY_SLICE_TIME) {
+        return;
+    }
+
+    WITH_QEMU_LOCK_GUARD(&s->lock) {
+        bytes_copied = call_state->bytes_copied;
+    }
+    /* Bytes per millisecond is precise enough and cannot overflow */
+    throughput = (bytes_copied - call_state->window_start_bytes) /
+                 (elapsed / SCALE_MS);
+
+    call_state->window_start_ns = now;
+    call_state->window_start_bytes = bytes_copied;
+
+    if (!throughput) {
+        /* Throttled or nothing left to copy, no useful signal */
+        return;
+    }
+
+    /* Tolerate 5% of noise before deciding the last move hurt */
+    if (throughput < call_state->last_throughput -
+                     call_state->last_throughput / 20) {
+        call_state->workers_step = -call_state->workers_step;
+    }
+    call_state->last_throughput = throughput;
+
+    step = MAX(1, call_state->workers / 4);
+    call_state->workers += call_state->workers_step > 0 ? step : -step;
+    call_state->workers = MAX(1, MIN(call_state->workers,
+                                     call_state->max_workers));
+
+    trace_block_copy_adapt_workers(s, throughput, call_state->workers);
+    aio_task_pool_set_max_busy_tasks(aio, call_state->workers);
+}
+
 /*
  * block_copy_dirty_clusters
  *
@@ -822,7 +890,24 @@ block_copy_dirty_clusters(BlockCopyCallState *call_state)
         bytes = end - offset;
 
         if (!aio && bytes) {
-            aio = aio_task_pool_new(call_state->max_workers);
+            if (call_state->adaptive_workers) {
+                if (!call_state->workers) {
+                    call_state->workers =
+                        MIN(BLOCK_COPY_ADAPTIVE_START_WORKERS,
+                            call_state->max_workers);
+                    call_state->workers_step = 1;
+                }
+                call_state->window_start_ns =
+                    qemu_clock_get_ns(QEMU_CLOCK_REALTIME);
+                WITH_QEMU_LOCK_GUARD(&s->lock) {
+                    call_state->window_start_bytes = call_state->bytes_copied;
+                }
+                aio = aio_task_pool_new(call_state->workers);
+            } else {
+                aio = aio_task_pool_new(call_state->max_workers);
+            }
+        } else if (aio && call_state->adaptive_workers) {
+            block_copy_adapt_workers(call_state, aio);
         }
 
         ret = block_copy_task_run(aio, task);
@@ -972,6 +1057,7 @@ int coroutine_fn block_copy(BlockCopyState *s, int64_t start, int64_t bytes,
 BlockCopyCallState *block_copy_async(BlockCopyState *s,
                                      int64_t offset, int64_t bytes,
                                      int max_workers, int64_t max_chunk,
+                                     bool adaptive_workers,
                                      BlockCopyAsyncCallbackFunc cb,
                                      void *cb_opaque)
 {
@@ -983,6 +1069,7 @@ BlockCopyCallState *block_copy_async(BlockCopyState *s,
         .bytes = bytes,
         .max_workers = max_workers,
         .max_chunk = max_chunk,
+        .adaptive_workers = adaptive_workers,
         .cb = cb,
         .cb_opaque = cb_opaque,
 
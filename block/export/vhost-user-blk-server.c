@@ -38,14 +38,28 @@ typedef struct {
     VirtioBlkHandler handler;
     QIOChannelSocket *sioc;
     struct virtio_blk_config blkcfg;
+
+    /*
+     * While vu_blk_process_vq() pops requests from @batch_vq, requests on
+     * that queue that complete without yielding only push their used element
+     * and set @batch_notify; a single notification is sent at the end of the
+     * batch.
+     */
+    VuVirtq *batch_vq;
+    bool batch_notify;
 } VuBlkExport;
 
 static void vu_blk_req_complete(VuBlkReq *req, size_t in_len)
 {
     VuDev *vu_dev = &req->server->vu_dev;
+    VuBlkExport *vexp = container_of(req->server, VuBlkExport, vu_server);
 
     vu_queue_push(vu_dev, req->vq, &req->elem, in_len);
-    vu_queue_notify(vu_dev, req->vq);
+    if (req->vq == vexp->batch_vq) {
+        vexp->batch_notify = true;
+    } else {
+        vu_queue_notify(vu_dev, req->vq);
+    }
 
     free(req);
 }
@@ -82,8 +96,13 @@ static void coroutine_fn vu_blk_virtio_process_req(void *opaque)
 static void vu_blk_process_vq(VuDev *vu_dev, int idx)
 {
     VuServer *server = container_of(vu_dev, VuServer, vu_dev);
+    VuBlkExport *vexp = container_of(server, VuBlkExport, vu_server);
     VuVirtq *vq = vu_get_queue(vu_dev, idx);
 
+    assert(!vexp->batch_vq);
+    vexp->batch_vq = vq;
+    vexp->batch_notify = false;
+
     while (1) {
         VuBlkReq *req;
 
@@ -101,6 +120,11 @@ static void vu_blk_process_vq(VuDev *vu_dev, int idx)
         vhost_user_server_inc_in_flight(server);
         qemu_coroutine_enter(co);
     }
+
+    vexp->batch_vq = NULL;
+    if (vexp->batch_notify) {
+        vu_queue_notify(vu_dev, vq);
+    }
 }
 
 static void vu_blk_queue_set_started(VuDev *vu_dev, int idx, bool started)
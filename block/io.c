@@ -38,6 +38,7 @@
 #include "qemu/error-report.h"
 #include "qemu/main-loop.h"
 #include "system/replay.h"
+#include "qemu/timer.h"
 
 /* Maximum bounce buffer for copy-on-read and write zeroes, in bytes */
 #define MAX_BOUNCE_BUFFER (32768 << BDRV_SECTOR_BITS)
@@ -1772,6 +1773,56 @@ int coroutine_fn bdrv_co_preadv(BdrvChild *child,
     return bdrv_co_preadv_part(child, offset, bytes, qiov, 0, flags);
 }
 
+const uint64_t bdrv_latency_boundaries[BDRV_LATENCY_NR_BINS - 1] = {
+    10 * SCALE_US, 50 * SCALE_US, 100 * SCALE_US, 500 * SCALE_US,
+    1 * SCALE_MS, 10 * SCALE_MS, 100 * SCALE_MS,
+};
+
+static inline int64_t bdrv_latency_start(BlockDriverState *bs)
+{
+    return qatomic_read(&bs->latency_accounting) ? get_clock() : 0;
+}
+
+static void bdrv_latency_done(BdrvLatencyStats *stats, int64_t start_ns)
+{
+    uint64_t ns;
+    int i;
+
+    if (!start_ns) {
+        return;
+    }
+
+    ns = get_clock() - start_ns;
+    for (i = 0; i < BDRV_LATENCY_NR_BINS - 1; i++) {
+        if (ns < bdrv_latency_boundaries[i]) {
+            break;
+        }
+    }
+
+    stat64_add(&stats->ops, 1);
+    stat64_add(&stats->total_ns, ns);
+    stat64_max(&stats->max_ns, ns);
+    stat64_add(&stats->bins[i], 1);
+}
+
+void bdrv_latency_accounting_set(BlockDriverState *bs, bool enable)
+{
+    BdrvLatencyStats *all[] = { &bs->rd_latency, &bs->wr_latency };
+    int i, j;
+
+    if (enable) {
+        for (i = 0; i < ARRAY_SIZE(all); i++) {
+            stat64_set(&all[i]->ops, 0);
+            stat64_set(&all[i]->total_ns, 0);
+            stat64_set(&all[i]->max_ns, 0);
+            for (j = 0; j < BDRV_LATENCY_NR_BINS; j++) {
+                stat64_set(&all[i]->bins[j], 0);
+            }
+        }
+    }
+    qatomic_set(&bs->latency_accounting, enable);
+}
+
 int coroutine_fn bdrv_co_preadv_part(BdrvChild *child,
     int64_t offset, int64_t bytes,
     QEMUIOVector *qiov, size_t qiov_offset,
@@ -1780,6 +1831,7 @@ int coroutine_fn bdrv_co_preadv_part(BdrvChild *child,
     BlockDriverState *bs = child->bs;
     BdrvTrackedRequest req;
     BdrvRequestPadding pad;
+    int64_t start_ns;
     int ret;
     IO_CODE();
 
@@ -1807,6 +1859,7 @@ int coroutine_fn bdrv_co_preadv_part(BdrvChild *child,
     }
 
     bdrv_inc_in_flight(bs);
+    start_ns = bdrv_latency_start(bs);
 
     /* Don't do copy-on-read if we read data before write operation */
     if (qatomic_read(&bs->copy_on_read)) {
@@ -1827,6 +1880,7 @@ int coroutine_fn bdrv_co_preadv_part(BdrvChild *child,
     bdrv_padding_finalize(&pad);
 
 fail:
+    bdrv_latency_done(&bs->rd_latency, start_ns);
     bdrv_dec_in_flight(bs);
 
     return ret;
@@ -2233,6 +2287,7 @@ int coroutine_fn bdrv_co_pwritev_part(BdrvChild *child,
     BdrvTrackedRequest req;
     uint64_t align = bs->bl.request_alignment;
     BdrvRequestPadding pad;
+    int64_t start_ns;
     int ret;
     bool padded = false;
     IO_CODE();
@@ -2285,6 +2340,7 @@ int coroutine_fn bdrv_co_pwritev_part(BdrvChild *child,
     }
 
     bdrv_inc_in_flight(bs);
+    start_ns = bdrv_latency_start(bs);
     tracked_request_begin(&req, bs, offset, bytes, BDRV_TRACKED_WRITE);
 
     if (flags & BDRV_REQ_ZERO_WRITE) {
@@ -2312,6 +2368,7 @@ int coroutine_fn bdrv_co_pwritev_part(BdrvChild *child,
 
 out:
     tracked_request_end(&req);
+    bdrv_latency_done(&bs->wr_latency, start_ns);
     bdrv_dec_in_flight(bs);
 
     return ret;
@@ -57,6 +57,9 @@ struct LuringState {
     /* No locking required, only accessed from AioContext home thread */
     LuringQueue io_q;
 
+    /* IORING_OP_READ and IORING_OP_WRITE are available */
+    bool has_rw;
+
     QEMUBH *completion_bh;
 };
 
@@ -90,6 +93,17 @@ static void luring_resubmit_short_read(LuringState *s, LuringAIOCB *luringcb,
     luringcb->total_read += nread;
     remaining = luringcb->qiov->size - luringcb->total_read;
 
+#ifdef HAVE_IO_URING_FREE_PROBE
+    if (luringcb->sqeq.opcode == IORING_OP_READ) {
+        /* Single buffer, see luring_do_submit() */
+        luringcb->sqeq.off += nread;
+        luringcb->sqeq.addr += nread;
+        luringcb->sqeq.len = remaining;
+        luring_resubmit(s, luringcb);
+        return;
+    }
+#endif
+
     /* Shorten qiov */
     resubmit_qiov = &luringcb->resubmit_qiov;
     if (resubmit_qiov->iov == NULL) {
@@ -167,10 +181,11 @@ static void luring_process_completions(LuringState *s)
 
         if (ret < 0) {
             /*
-             * Only writev/readv/fsync requests on regular files or host block
-             * devices are submitted. Therefore -EAGAIN is not expected but it's
-             * known to happen sometimes with Linux SCSI. Submit again and hope
-             * the request completes successfully.
+             * Only read/write (single buffer), readv/writev and fsync
+             * requests on regular files or host block devices are
+             * submitted. Therefore -EAGAIN is not expected but it's known to
+             * happen sometimes with Linux SCSI. Submit again and hope the
+             * request completes successfully.
              *
              * For more information, see:
              * https://lore.kernel.org/io-uring/20210727165811.284510-3-axboe@kernel.dk/T/#u
@@ -339,9 +354,23 @@ static int luring_do_submit(int fd, LuringAIOCB *luringcb, LuringState *s,
 {
     int ret;
     struct io_uring_sqe *sqes = &luringcb->sqeq;
+#ifdef HAVE_IO_URING_FREE_PROBE
+    /*
+     * The kernel does not have to copy and validate an iovec array for
+     * single-buffer requests, which are the common case for raw images.
+     */
+    bool single = s->has_rw && luringcb->qiov && luringcb->qiov->niov == 1;
+#endif
 
     switch (type) {
     case QEMU_AIO_WRITE:
+#ifdef HAVE_IO_URING_FREE_PROBE
+        if (single && !(flags & BDRV_REQ_FUA)) {
+            io_uring_prep_write(sqes, fd, luringcb->qiov->iov[0].iov_base,
+                                luringcb->qiov->iov[0].iov_len, offset);
+            break;
+        }
+#endif
 #ifdef HAVE_IO_URING_PREP_WRITEV2
     {
         int luring_flags = (flags & BDRV_REQ_FUA) ? RWF_DSYNC : 0;
@@ -359,6 +388,13 @@ static int luring_do_submit(int fd, LuringAIOCB *luringcb, LuringState *s,
                              luringcb->qiov->niov, offset);
         break;
     case QEMU_AIO_READ:
+#ifdef HAVE_IO_URING_FREE_PROBE
+        if (single) {
+            io_uring_prep_read(sqes, fd, luringcb->qiov->iov[0].iov_base,
+                               luringcb->qiov->iov[0].iov_len, offset);
+            break;
+        }
+#endif
         io_uring_prep_readv(sqes, fd, luringcb->qiov->iov,
                             luringcb->qiov->niov, offset);
         break;
@@ -447,6 +483,18 @@ LuringState *luring_init(Error **errp)
         return NULL;
     }
 
+#ifdef HAVE_IO_URING_FREE_PROBE
+    {
+        struct io_uring_probe *probe = io_uring_get_probe_ring(ring);
+
+        if (probe) {
+            s->has_rw = io_uring_opcode_supported(probe, IORING_OP_READ) &&
+                        io_uring_opcode_supported(probe, IORING_OP_WRITE);
+            io_uring_free_probe(probe);
+        }
+    }
+#endif
+
     ioq_init(&s->io_q);
     return s;
 
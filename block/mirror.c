@@ -265,7 +265,21 @@ static void coroutine_fn mirror_read_complete(MirrorOp *op, int ret)
         return;
     }
 
-    ret = blk_co_pwritev(s->target, op->offset, op->qiov.size, &op->qiov, 0);
+    /*
+     * Block status only knows about zeroes the format tracks as such; data
+     * clusters that happen to be zero (e.g. a thin disk that was zeroed by
+     * the guest or a previous raw copy) would otherwise be written out in
+     * full.  Turn them into efficient zero writes on the target.
+     */
+    if (bdrv_can_write_zeroes_with_unmap(blk_bs(s->target)) &&
+        qemu_iovec_is_zero(&op->qiov, 0, op->qiov.size)) {
+        trace_mirror_zero_buffer(s, op->offset, op->qiov.size);
+        ret = blk_co_pwrite_zeroes(s->target, op->offset, op->qiov.size,
+                                   s->unmap ? BDRV_REQ_MAY_UNMAP : 0);
+    } else {
+        ret = blk_co_pwritev(s->target, op->offset, op->qiov.size,
+                             &op->qiov, 0);
+    }
     mirror_write_complete(op, ret);
 }
 
@@ -138,6 +138,9 @@ struct BDRVNVMeState {
         uint64_t completion_errors;
         uint64_t aligned_accesses;
         uint64_t unaligned_accesses;
+        uint64_t completions;
+        uint64_t polled_completions;
+        uint64_t interrupt_completions;
     } stats;
 };
 
@@ -426,6 +429,7 @@ static bool nvme_process_completion(NVMeQueuePair *q)
             continue;
         }
         trace_nvme_complete_command(s, q->index, cid);
+        s->stats.completions++;
         preq = &q->reqs[cid - 1];
         req = *preq;
         assert(req.cid == cid);
@@ -647,13 +651,29 @@ static void nvme_poll_queue(NVMeQueuePair *q)
     qemu_mutex_unlock(&q->lock);
 }
 
-static void nvme_poll_queues(BDRVNVMeState *s)
+/*
+ * Reap completions on all queues.  @polled tells whether we got here from
+ * the AioContext polling loop or from the MSI-X interrupt, so that the split
+ * can be reported in query-blockstats and used to judge whether poll-max-ns
+ * is tuned sensibly for the device.  Completions reaped elsewhere, by
+ * nvme_deferred_fn() after submission or by nvme_process_completion_bh()
+ * in a nested aio_poll(), fall in neither bucket.
+ */
+static void nvme_poll_queues(BDRVNVMeState *s, bool polled)
 {
+    uint64_t completions = s->stats.completions;
     int i;
 
     for (i = 0; i < s->queue_count; i++) {
         nvme_poll_queue(s->queues[i]);
     }
+
+    completions = s->stats.completions - completions;
+    if (polled) {
+        s->stats.polled_completions += completions;
+    } else {
+        s->stats.interrupt_completions += completions;
+    }
 }
 
 static void nvme_handle_event(EventNotifier *n)
@@ -663,7 +683,7 @@ static void nvme_handle_event(EventNotifier *n)
 
     trace_nvme_handle_event(s);
     event_notifier_test_and_clear(n);
-    nvme_poll_queues(s);
+    nvme_poll_queues(s, false);
 }
 
 static bool nvme_add_io_queue(BlockDriverState *bs, Error **errp)
@@ -737,7 +757,7 @@ static void nvme_poll_ready(EventNotifier *e)
     BDRVNVMeState *s = container_of(e, BDRVNVMeState,
                                     irq_notifier[MSIX_SHARED_IRQ_IDX]);
 
-    nvme_poll_queues(s);
+    nvme_poll_queues(s, true);
 }
 
 static int nvme_init(BlockDriverState *bs, const char *device, int namespace,
@@ -1609,6 +1629,8 @@ static BlockStatsSpecific *nvme_get_specific_stats(BlockDriverState *bs)
         .completion_errors = s->stats.completion_errors,
         .aligned_accesses = s->stats.aligned_accesses,
         .unaligned_accesses = s->stats.unaligned_accesses,
+        .polled_completions = s->stats.polled_completions,
+        .interrupt_completions = s->stats.interrupt_completions,
     };
 
     return stats;
@@ -572,3 +572,19 @@ void qmp_block_latency_histogram_set(
         }
     }
 }
+
+void qmp_x_block_node_latency_accounting(const char *node_name, bool enable,
+                                         Error **errp)
+{
+    BlockDriverState *bs;
+
+    GRAPH_RDLOCK_GUARD_MAINLOOP();
+
+    bs = bdrv_find_node(node_name);
+    if (!bs) {
+        error_setg(errp, "Node '%s' not found", node_name);
+        return;
+    }
+
+    bdrv_latency_accounting_set(bs, enable);
+}
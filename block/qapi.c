@@ -464,7 +464,7 @@ bdrv_query_info(BlockBackend *blk, BlockInfo **p_info, Error **errp)
     qapi_free_BlockInfo(info);
 }
 
-static uint64List *uint64_list(uint64_t *list, int size)
+static uint64List *uint64_list(const uint64_t *list, int size)
 {
     int i;
     uint64List *out_list = NULL;
@@ -492,6 +492,42 @@ bdrv_latency_histogram_stats(BlockLatencyHistogram *hist)
     return info;
 }
 
+static BlockLatencyHistogramInfo *
+bdrv_node_latency_histogram(BdrvLatencyStats *stats)
+{
+    BlockLatencyHistogramInfo *info = g_new0(BlockLatencyHistogramInfo, 1);
+    uint64_t bins[BDRV_LATENCY_NR_BINS];
+    int i;
+
+    for (i = 0; i < BDRV_LATENCY_NR_BINS; i++) {
+        bins[i] = stat64_get(&stats->bins[i]);
+    }
+    info->boundaries = uint64_list(bdrv_latency_boundaries,
+                                   BDRV_LATENCY_NR_BINS - 1);
+    info->bins = uint64_list(bins, BDRV_LATENCY_NR_BINS);
+    return info;
+}
+
+static BlockNodeLatencyStats *bdrv_query_node_latency(BlockDriverState *bs)
+{
+    BlockNodeLatencyStats *ls;
+
+    if (!qatomic_read(&bs->latency_accounting)) {
+        return NULL;
+    }
+
+    ls = g_new0(BlockNodeLatencyStats, 1);
+    ls->rd_operations = stat64_get(&bs->rd_latency.ops);
+    ls->rd_total_time_ns = stat64_get(&bs->rd_latency.total_ns);
+    ls->rd_max_time_ns = stat64_get(&bs->rd_latency.max_ns);
+    ls->rd_histogram = bdrv_node_latency_histogram(&bs->rd_latency);
+    ls->wr_operations = stat64_get(&bs->wr_latency.ops);
+    ls->wr_total_time_ns = stat64_get(&bs->wr_latency.total_ns);
+    ls->wr_max_time_ns = stat64_get(&bs->wr_latency.max_ns);
+    ls->wr_histogram = bdrv_node_latency_histogram(&bs->wr_latency);
+    return ls;
+}
+
 static void bdrv_query_blk_stats(BlockDeviceStats *ds, BlockBackend *blk)
 {
     BlockAcctStats *stats = blk_get_stats(blk);
@@ -617,6 +653,7 @@ bdrv_query_bds_stats(BlockDriverState *bs, bool blk_level)
     s->stats->wr_highest_offset = stat64_get(&bs->wr_highest_offset);
 
     s->driver_specific = bdrv_get_specific_stats(bs);
+    s->node_latency = bdrv_query_node_latency(bs);
 
     parent_child = bdrv_primary_child(bs);
     if (!parent_child ||
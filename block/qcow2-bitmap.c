@@ -63,6 +63,12 @@ QEMU_BUILD_BUG_ON(BME_MAX_NAME_SIZE != BDRV_BITMAP_MAX_NAME_SIZE);
 #define BME_TABLE_ENTRY_OFFSET_MASK 0x00fffffffffffe00ULL
 #define BME_TABLE_ENTRY_FLAG_ALL_ONES (1ULL << 0)
 
+/*
+ * Bitmap data clusters are usually allocated back to back, so load and store
+ * runs of them with a single request of up to this size.
+ */
+#define BITMAP_IO_BATCH_SIZE (1 * MiB)
+
 typedef struct QEMU_PACKED Qcow2BitmapDirEntry {
     /* header is 8 byte aligned */
     uint64_t bitmap_table_offset;
@@ -294,6 +300,7 @@ load_bitmap_data(BlockDriverState *bs, const uint64_t *bitmap_table,
     uint64_t offset, limit;
     uint64_t bm_size = bdrv_dirty_bitmap_size(bitmap);
     uint8_t *buf = NULL;
+    uint64_t batch, n, j;
     uint64_t i, tab_size =
             size_to_clusters(s,
                 bdrv_dirty_bitmap_serialization_size(bitmap, 0, bm_size));
@@ -302,16 +309,19 @@ load_bitmap_data(BlockDriverState *bs, const uint64_t *bitmap_table,
         return -EINVAL;
     }
 
-    buf = g_malloc(s->cluster_size);
+    batch = MAX(1, BITMAP_IO_BATCH_SIZE / s->cluster_size);
+    buf = g_malloc(batch * s->cluster_size);
     limit = bdrv_dirty_bitmap_serialization_coverage(s->cluster_size, bitmap);
-    for (i = 0, offset = 0; i < tab_size; ++i, offset += limit) {
-        uint64_t count = MIN(bm_size - offset, limit);
+    for (i = 0, offset = 0; i < tab_size; i += n, offset += n * limit) {
         uint64_t entry = bitmap_table[i];
         uint64_t data_offset = entry & BME_TABLE_ENTRY_OFFSET_MASK;
 
         assert(check_table_entry(entry, s->cluster_size) == 0);
 
+        n = 1;
         if (data_offset == 0) {
+            uint64_t count = MIN(bm_size - offset, limit);
+
             if (entry & BME_TABLE_ENTRY_FLAG_ALL_ONES) {
                 bdrv_dirty_bitmap_deserialize_ones(bitmap, offset, count,
                                                    false);
@@ -319,13 +329,30 @@ load_bitmap_data(BlockDriverState *bs, const uint64_t *bitmap_table,
                 /* No need to deserialize zeros because the dirty bitmap is
                  * already cleared */
             }
-        } else {
-            ret = bdrv_co_pread(bs->file, data_offset, s->cluster_size, buf, 0);
-            if (ret < 0) {
-                goto finish;
-            }
-            bdrv_dirty_bitmap_deserialize_part(bitmap, buf, offset, count,
-                                               false);
+            continue;
+        }
+
+        /* Extend the read over physically contiguous data clusters */
+        while (n < batch && i + n < tab_size &&
+               (bitmap_table[i + n] & BME_TABLE_ENTRY_OFFSET_MASK) ==
+               data_offset + n * s->cluster_size) {
+            assert(check_table_entry(bitmap_table[i + n],
+                                     s->cluster_size) == 0);
+            n++;
+        }
+
+        ret = bdrv_co_pread(bs->file, data_offset, n * s->cluster_size, buf,
+                            0);
+        if (ret < 0) {
+            goto finish;
+        }
+        for (j = 0; j < n; j++) {
+            uint64_t part_offset = offset + j * limit;
+            uint64_t count = MIN(bm_size - part_offset, limit);
+
+            bdrv_dirty_bitmap_deserialize_part(bitmap,
+                                               buf + j * s->cluster_size,
+                                               part_offset, count, false);
         }
     }
     ret = 0;
@@ -1288,6 +1315,7 @@ store_bitmap_data(BlockDriverState *bs, BdrvDirtyBitmap *bitmap,
     const char *bm_name = bdrv_dirty_bitmap_name(bitmap);
     uint8_t *buf = NULL;
     uint64_t *tb;
+    uint64_t batch;
     uint64_t tb_size =
             size_to_clusters(s,
                 bdrv_dirty_bitmap_serialization_size(bitmap, 0, bm_size));
@@ -1305,7 +1333,8 @@ store_bitmap_data(BlockDriverState *bs, BdrvDirtyBitmap *bitmap,
         return NULL;
     }
 
-    buf = g_malloc(s->cluster_size);
+    batch = MAX(1, BITMAP_IO_BATCH_SIZE / s->cluster_size);
+    buf = g_malloc(batch * s->cluster_size);
     limit = bdrv_dirty_bitmap_serialization_coverage(s->cluster_size, bitmap);
     assert(DIV_ROUND_UP(bm_size, limit) == tb_size);
 
@@ -1314,48 +1343,65 @@ store_bitmap_data(BlockDriverState *bs, BdrvDirtyBitmap *bitmap,
            >= 0)
     {
         uint64_t cluster = offset / limit;
-        uint64_t end, write_size;
+        uint64_t n, j;
         int64_t off;
 
         /*
          * We found the first dirty offset, but want to write out the
          * entire cluster of the bitmap that includes that offset,
-         * including any leading zero bits.
+         * including any leading zero bits.  Following clusters that also
+         * contain dirty bits are allocated and written together with it.
          */
         offset = QEMU_ALIGN_DOWN(offset, limit);
-        end = MIN(bm_size, offset + limit);
-        write_size = bdrv_dirty_bitmap_serialization_size(bitmap, offset,
-                                                          end - offset);
-        assert(write_size <= s->cluster_size);
+        n = 1;
+        while (n < batch && cluster + n < tb_size &&
+               bdrv_dirty_bitmap_next_dirty(bitmap, offset + n * limit,
+                                            limit) >= 0) {
+            n++;
+        }
 
-        off = qcow2_alloc_clusters(bs, s->cluster_size);
+        off = qcow2_alloc_clusters(bs, n * s->cluster_size);
         if (off < 0) {
             error_setg_errno(errp, -off,
                              "Failed to allocate clusters for bitmap '%s'",
                              bm_name);
             goto fail;
         }
-        tb[cluster] = off;
 
-        bdrv_dirty_bitmap_serialize_part(bitmap, buf, offset, end - offset);
-        if (write_size < s->cluster_size) {
-            memset(buf + write_size, 0, s->cluster_size - write_size);
+        for (j = 0; j < n; j++) {
+            uint64_t part_offset = offset + j * limit;
+            uint64_t end = MIN(bm_size, part_offset + limit);
+            uint64_t write_size =
+                bdrv_dirty_bitmap_serialization_size(bitmap, part_offset,
+                                                     end - part_offset);
+            uint8_t *part_buf = buf + j * s->cluster_size;
+
+            assert(write_size <= s->cluster_size);
+            tb[cluster + j] = off + j * s->cluster_size;
+
+            bdrv_dirty_bitmap_serialize_part(bitmap, part_buf, part_offset,
+                                             end - part_offset);
+            if (write_size < s->cluster_size) {
+                memset(part_buf + write_size, 0,
+                       s->cluster_size - write_size);
+            }
         }
 
-        ret = qcow2_pre_write_overlap_check(bs, 0, off, s->cluster_size, false);
+        ret = qcow2_pre_write_overlap_check(bs, 0, off, n * s->cluster_size,
+                                            false);
         if (ret < 0) {
             error_setg_errno(errp, -ret, "Qcow2 overlap check failed");
             goto fail;
         }
 
-        ret = bdrv_pwrite(bs->file, off, s->cluster_size, buf, 0);
+        ret = bdrv_pwrite(bs->file, off, n * s->cluster_size, buf, 0);
         if (ret < 0) {
             error_setg_errno(errp, -ret, "Failed to write bitmap '%s' to file",
                              bm_name);
             goto fail;
         }
 
-        offset = end;
+        offset = MIN(bm_size, offset + n * limit);
     }
 
     *bitmap_table_size = tb_size;
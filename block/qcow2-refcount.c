@@ -23,6 +23,7 @@
  */
 
 #include "qemu/osdep.h"
+#include "block/aio_task.h"
 #include "block/block-io.h"
 #include "qapi/error.h"
 #include "qcow2.h"
@@ -733,11 +734,63 @@ fail:
     return ret;
 }
 
-void qcow2_process_discards(BlockDriverState *bs, int ret)
+typedef struct Qcow2DiscardTask {
+    AioTask task;
+    BlockDriverState *bs;
+    uint64_t offset;
+    uint64_t bytes;
+} Qcow2DiscardTask;
+
+/*
+ * This function can count as GRAPH_RDLOCK because qcow2_process_discards()
+ * holds the graph lock and waits for all tasks to terminate.
+ */
+static int coroutine_fn GRAPH_RDLOCK qcow2_discard_task_entry(AioTask *task)
+{
+    Qcow2DiscardTask *t = container_of(task, Qcow2DiscardTask, task);
+    int ret;
+
+    ret = bdrv_co_pdiscard(t->bs->file, t->offset, t->bytes);
+    if (ret < 0) {
+        trace_qcow2_process_discards_failed_region(t->offset, t->bytes, ret);
+    }
+
+    /* Discard is optional, a failure must not fail the other tasks */
+    return 0;
+}
+
+void coroutine_mixed_fn qcow2_process_discards(BlockDriverState *bs, int ret)
 {
     BDRVQcow2State *s = bs->opaque;
     Qcow2DiscardRegion *d, *next;
 
+    /*
+     * Unless there is a single region, keep up to QCOW2_MAX_WORKERS
+     * discards in flight instead of waiting for each one in turn.
+     */
+    if (ret >= 0 && qemu_in_coroutine() &&
+        QTAILQ_FIRST(&s->discards) != QTAILQ_LAST(&s->discards)) {
+        AioTaskPool *aio = aio_task_pool_new(QCOW2_MAX_WORKERS);
+
+        QTAILQ_FOREACH_SAFE(d, &s->discards, next, next) {
+            Qcow2DiscardTask *t = g_new(Qcow2DiscardTask, 1);
+
+            QTAILQ_REMOVE(&s->discards, d, next);
+            *t = (Qcow2DiscardTask) {
+                .task.func = qcow2_discard_task_entry,
+                .bs = bs,
+                .offset = d->offset,
+                .bytes = d->bytes,
+            };
+            g_free(d);
+            aio_task_pool_start_task(aio, &t->task);
+        }
+
+        aio_task_pool_wait_all(aio);
+        aio_task_pool_free(aio);
+        return;
+    }
+
     QTAILQ_FOREACH_SAFE(d, &s->discards, next, next) {
         QTAILQ_REMOVE(&s->discards, d, next);
 
@@ -964,12 +1017,75 @@ int qcow2_update_cluster_refcount(BlockDriverState *bs,
 
 
 
+/*
+ * Count the clusters with a refcount of 0 starting at @cluster_index,
+ * stopping at the first cluster in use or after @max clusters, and store
+ * the count in *@nb_free.  Each refcount block is looked up only once.
+ * Returns 0 on success and -errno on failure.
+ */
+static int GRAPH_RDLOCK
+count_free_clusters(BlockDriverState *bs, uint64_t cluster_index,
+                    uint64_t max, uint64_t *nb_free)
+{
+    BDRVQcow2State *s = bs->opaque;
+    uint64_t n = 0;
+
+    while (n < max) {
+        uint64_t index = cluster_index + n;
+        uint64_t refcount_table_index = index >> s->refcount_block_bits;
+        uint64_t block_index = index & (s->refcount_block_size - 1);
+        uint64_t chunk = MIN(max - n, s->refcount_block_size - block_index);
+        int64_t refcount_block_offset = 0;
+        void *refcount_block;
+        uint64_t i;
+        int ret;
+
+        if (refcount_table_index < s->refcount_table_size) {
+            refcount_block_offset =
+                s->refcount_table[refcount_table_index] & REFT_OFFSET_MASK;
+        }
+        if (!refcount_block_offset) {
+            /* No refcount block yet: all of its clusters are free */
+            n += chunk;
+            continue;
+        }
+
+        if (offset_into_cluster(s, refcount_block_offset)) {
+            qcow2_signal_corruption(bs, true, -1, -1, "Refblock offset %#"
+                                    PRIx64 " unaligned (reftable index: %#"
+                                    PRIx64 ")", refcount_block_offset,
+                                    refcount_table_index);
+            return -EIO;
+        }
+
+        ret = qcow2_cache_get(bs, s->refcount_block_cache,
+                              refcount_block_offset, &refcount_block);
+        if (ret < 0) {
+            return ret;
+        }
+        for (i = 0; i < chunk; i++) {
+            if (s->get_refcount(refcount_block, block_index + i) != 0) {
+                break;
+            }
+        }
+        qcow2_cache_put(s->refcount_block_cache, &refcount_block);
+
+        n += i;
+        if (i < chunk) {
+            break;
+        }
+    }
+
+    *nb_free = n;
+    return 0;
+}
+
 /* return < 0 if error */
 static int64_t GRAPH_RDLOCK
 alloc_clusters_noref(BlockDriverState *bs, uint64_t size, uint64_t max)
 {
     BDRVQcow2State *s = bs->opaque;
-    uint64_t i, nb_clusters, refcount;
+    uint64_t i, nb_clusters, nb_free;
     int ret;
 
     /* We can't allocate clusters if they may still be queued for discard. */
@@ -978,15 +1094,19 @@ alloc_clusters_noref(BlockDriverState *bs, uint64_t size, uint64_t max)
     }
 
     nb_clusters = size_to_clusters(s, size);
-retry:
-    for(i = 0; i < nb_clusters; i++) {
-        uint64_t next_cluster_index = s->free_cluster_index++;
-        ret = qcow2_get_refcount(bs, next_cluster_index, &refcount);
-
+    i = 0;
+    while (i < nb_clusters) {
+        ret = count_free_clusters(bs, s->free_cluster_index, nb_clusters - i,
+                                  &nb_free);
         if (ret < 0) {
             return ret;
-        } else if (refcount != 0) {
-            goto retry;
+        }
+        s->free_cluster_index += nb_free;
+        i += nb_free;
+        if (i < nb_clusters) {
+            /* Skip the cluster in use and look for a new free range */
+            s->free_cluster_index++;
+            i = 0;
         }
     }
 
@@ -41,24 +41,9 @@
 static int coroutine_fn
 qcow2_co_process(BlockDriverState *bs, ThreadPoolFunc *func, void *arg)
 {
-    int ret;
     BDRVQcow2State *s = bs->opaque;
 
-    qemu_co_mutex_lock(&s->lock);
-    while (s->nb_threads >= QCOW2_MAX_THREADS) {
-        qemu_co_queue_wait(&s->thread_task_queue, &s->lock);
-    }
-    s->nb_threads++;
-    qemu_co_mutex_unlock(&s->lock);
-
-    ret = thread_pool_submit_co(func, arg);
-
-    qemu_co_mutex_lock(&s->lock);
-    s->nb_threads--;
-    qemu_co_queue_next(&s->thread_task_queue);
-    qemu_co_mutex_unlock(&s->lock);
-
-    return ret;
+    return thread_pool_limit_submit_co(&s->thread_limit, func, arg);
 }
 
 
@@ -1887,7 +1887,7 @@ qcow2_do_open(BlockDriverState *bs, QDict *options, int flags,
     }
 #endif
 
-    qemu_co_queue_init(&s->thread_task_queue);
+    thread_pool_limit_init(&s->thread_limit);
 
     return ret;
 
@@ -4829,17 +4829,33 @@ qcow2_co_preadv_compressed(BlockDriverState *bs,
     BDRVQcow2State *s = bs->opaque;
     int ret = 0, csize;
     uint64_t coffset;
-    uint8_t *buf, *out_buf;
+    uint8_t *buf, *out_buf = NULL, *direct_buf = NULL;
     int offset_in_cluster = offset_into_cluster(s, offset);
 
     qcow2_parse_compressed_l2_entry(bs, l2_entry, &coffset, &csize);
 
+    /*
+     * Sequential reads of compressed images usually cover whole clusters;
+     * decompress straight into the caller's buffer if it is contiguous.
+     */
+    if (offset_in_cluster == 0 && bytes == s->cluster_size) {
+        size_t head, tail;
+        int niov;
+        struct iovec *iov = qemu_iovec_slice(qiov, qiov_offset, bytes,
+                                             &head, &tail, &niov);
+        if (niov == 1) {
+            direct_buf = (uint8_t *)iov->iov_base + head;
+        }
+    }
+
     buf = g_try_malloc(csize);
     if (!buf) {
         return -ENOMEM;
     }
 
-    out_buf = qemu_blockalign(bs, s->cluster_size);
+    if (!direct_buf) {
+        out_buf = qemu_blockalign(bs, s->cluster_size);
+    }
 
     BLKDBG_CO_EVENT(bs->file, BLKDBG_READ_COMPRESSED);
     ret = bdrv_co_pread(bs->file, coffset, csize, buf, 0);
@@ -4847,12 +4863,16 @@ qcow2_co_preadv_compressed(BlockDriverState *bs,
         goto fail;
     }
 
-    if (qcow2_co_decompress(bs, out_buf, s->cluster_size, buf, csize) < 0) {
+    if (qcow2_co_decompress(bs, direct_buf ?: out_buf, s->cluster_size,
+                            buf, csize) < 0) {
         ret = -EIO;
         goto fail;
     }
 
-    qemu_iovec_from_buf(qiov, qiov_offset, out_buf + offset_in_cluster, bytes);
+    if (!direct_buf) {
+        qemu_iovec_from_buf(qiov, qiov_offset, out_buf + offset_in_cluster,
+                            bytes);
+    }
 
 fail:
     qemu_vfree(out_buf);
@@ -29,6 +29,7 @@
 #include "qemu/coroutine.h"
 #include "qemu/units.h"
 #include "block/block_int.h"
+#include "block/thread-pool.h"
 
 //#define DEBUG_ALLOC
 //#define DEBUG_ALLOC2
@@ -322,8 +323,6 @@ typedef struct Qcow2BitmapHeaderExt {
     uint64_t bitmap_directory_offset;
 } QEMU_PACKED Qcow2BitmapHeaderExt;
 
-#define QCOW2_MAX_THREADS 4
-
 typedef struct BDRVQcow2State {
     int cluster_bits;
     int cluster_size;
@@ -408,8 +407,8 @@ typedef struct BDRVQcow2State {
     char *image_backing_format;
     char *image_data_file;
 
-    CoQueue thread_task_queue;
-    int nb_threads;
+    /* Limits the number of compression/encryption jobs in the thread pool */
+    ThreadPoolLimit thread_limit;
 
     BdrvChild *data_file;
 
@@ -890,7 +889,8 @@ int GRAPH_RDLOCK qcow2_write_caches(BlockDriverState *bs);
 int coroutine_fn qcow2_check_refcounts(BlockDriverState *bs, BdrvCheckResult *res,
                                        BdrvCheckMode fix);
 
-void GRAPH_RDLOCK qcow2_process_discards(BlockDriverState *bs, int ret);
+void coroutine_mixed_fn GRAPH_RDLOCK
+qcow2_process_discards(BlockDriverState *bs, int ret);
 
 int GRAPH_RDLOCK
 qcow2_check_metadata_overlap(BlockDriverState *bs, int ign, int64_t offset,
@@ -0,0 +1,312 @@
+/*
+ * Read-ahead filter block driver
+ *
+ * The driver detects sequential read streams and turns them into fewer,
+ * larger requests on its child, serving following reads from memory.  It
+ * is meant for protocol drivers with a high per-request latency, such as
+ * http, nfs or rbd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "qemu/osdep.h"
+
+#include "qapi/error.h"
+#include "qemu/memalign.h"
+#include "qemu/module.h"
+#include "qemu/option.h"
+#include "qemu/units.h"
+#include "block/block-io.h"
+#include "block/block_int.h"
+
+#define READAHEAD_OPT_SIZE "size"
+#define READAHEAD_DEFAULT_SIZE (1 * MiB)
+#define READAHEAD_MAX_SIZE (64 * MiB)
+
+typedef struct BDRVReadaheadState {
+    int64_t size;
+
+    /* Protects all fields below */
+    QemuMutex lock;
+
+    /* End of the last read, a read starting here is considered sequential */
+    int64_t next_offset;
+
+    /* The window [@buf_offset, @buf_offset + @buf_bytes) is cached in @buf */
+    uint8_t *buf;
+    int64_t buf_offset;
+    int64_t buf_bytes;
+
+    /*
+     * A single fill request is in flight at a time, into @fill_buf which is
+     * swapped with @buf on completion.
+     */
+    uint8_t *fill_buf;
+    bool filling;
+
+    /*
+     * Incremented by every write before and after it is submitted, so that a
+     * fill racing with a write can tell that its data may be stale.
+     */
+    uint64_t generation;
+} BDRVReadaheadState;
+
+static QemuOptsList runtime_opts = {
+    .name = "readahead",
+    .head = QTAILQ_HEAD_INITIALIZER(runtime_opts.head),
+    .desc = {
+        {
+            .name = READAHEAD_OPT_SIZE,
+            .type = QEMU_OPT_SIZE,
+            .help = "size of a read-ahead request, default 1M",
+        },
+        { /* end of list */ }
+    },
+};
+
+static int readahead_open(BlockDriverState *bs, QDict *options, int flags,
+                          Error **errp)
+{
+    BDRVReadaheadState *s = bs->opaque;
+    QemuOpts *opts;
+    int ret;
+
+    GLOBAL_STATE_CODE();
+
+    ret = bdrv_open_file_child(NULL, options, "file", bs, errp);
+    if (ret < 0) {
+        return ret;
+    }
+
+    opts = qemu_opts_create(&runtime_opts, NULL, 0, &error_abort);
+    if (!qemu_opts_absorb_qdict(opts, options, errp)) {
+        qemu_opts_del(opts);
+        return -EINVAL;
+    }
+    s->size = qemu_opt_get_size(opts, READAHEAD_OPT_SIZE,
+                                READAHEAD_DEFAULT_SIZE);
+    qemu_opts_del(opts);
+
+    GRAPH_RDLOCK_GUARD_MAINLOOP();
+
+    if (s->size < BDRV_SECTOR_SIZE || s->size > READAHEAD_MAX_SIZE ||
+        !QEMU_IS_ALIGNED(s->size, bs->file->bs->bl.request_alignment)) {
+        error_setg(errp, "size parameter of readahead filter must be a "
+                   "multiple of %" PRIu32 " between %llu and %" PRId64,
+                   bs->file->bs->bl.request_alignment, BDRV_SECTOR_SIZE,
+                   READAHEAD_MAX_SIZE);
+        return -EINVAL;
+    }
+
+    s->buf = qemu_try_blockalign(bs->file->bs, s->size);
+    s->fill_buf = qemu_try_blockalign(bs->file->bs, s->size);
+    if (!s->buf || !s->fill_buf) {
+        qemu_vfree(s->buf);
+        qemu_vfree(s->fill_buf);
+        error_setg(errp, "Could not allocate read-ahead buffers");
+        return -ENOMEM;
+    }
+
+    qemu_mutex_init(&s->lock);
+    s->next_offset = -1;
+
+    bs->supported_write_flags = BDRV_REQ_WRITE_UNCHANGED |
+        (BDRV_REQ_FUA & bs->file->bs->supported_write_flags);
+
+    bs->supported_zero_flags = BDRV_REQ_WRITE_UNCHANGED |
+        ((BDRV_REQ_FUA | BDRV_REQ_MAY_UNMAP | BDRV_REQ_NO_FALLBACK) &
+            bs->file->bs->supported_zero_flags);
+
+    return 0;
+}
+
+static void readahead_close(BlockDriverState *bs)
+{
+    BDRVReadaheadState *s = bs->opaque;
+
+    qemu_vfree(s->buf);
+    qemu_vfree(s->fill_buf);
+    qemu_mutex_destroy(&s->lock);
+}
+
+static void readahead_child_perm(BlockDriverState *bs, BdrvChild *c,
+    BdrvChildRole role, BlockReopenQueue *reopen_queue,
+    uint64_t perm, uint64_t shared, uint64_t *nperm, uint64_t *nshared)
+{
+    bdrv_default_perms(bs, c, role, reopen_queue, perm, shared, nperm, nshared);
+
+    /* Writes that bypass us would leave stale data in the cache */
+    *nshared &= ~(BLK_PERM_WRITE | BLK_PERM_RESIZE);
+}
+
+static int64_t coroutine_fn GRAPH_RDLOCK
+readahead_co_getlength(BlockDriverState *bs)
+{
+    return bdrv_co_getlength(bs->file->bs);
+}
+
+/* Called with s->lock held */
+static bool readahead_cache_hit(BDRVReadaheadState *s, int64_t offset,
+                                int64_t bytes)
+{
+    return s->buf_bytes && offset >= s->buf_offset &&
+           offset + bytes <= s->buf_offset + s->buf_bytes;
+}
+
+static void readahead_invalidate(BDRVReadaheadState *s, int64_t offset,
+                                 int64_t bytes)
+{
+    QEMU_LOCK_GUARD(&s->lock);
+
+    s->generation++;
+    if (s->buf_bytes && offset < s->buf_offset + s->buf_bytes &&
+        offset + bytes > s->buf_offset) {
+        s->buf_bytes = 0;
+    }
+}
+
+static int coroutine_fn GRAPH_RDLOCK
+readahead_co_preadv_part(BlockDriverState *bs, int64_t offset, int64_t bytes,
+                         QEMUIOVector *qiov, size_t qiov_offset,
+                         BdrvRequestFlags flags)
+{
+    BDRVReadaheadState *s = bs->opaque;
+    int64_t fill_bytes = 0;
+    uint64_t generation;
+    uint8_t *fill_buf;
+    int ret;
+
+    WITH_QEMU_LOCK_GUARD(&s->lock) {
+        bool sequential = offset == s->next_offset;
+
+        s->next_offset = offset + bytes;
+
+        if (readahead_cache_hit(s, offset, bytes)) {
+            qemu_iovec_from_buf(qiov, qiov_offset,
+                                s->buf + (offset - s->buf_offset), bytes);
+            return 0;
+        }
+
+        if (sequential && !s->filling && bytes < s->size) {
+            int64_t len = bs->total_sectors * BDRV_SECTOR_SIZE;
+
+            fill_bytes = QEMU_ALIGN_DOWN(MIN(s->size, len - offset),
+                                         bs->file->bs->bl.request_alignment);
+            if (fill_bytes < bytes) {
+                fill_bytes = 0;
+            } else {
+                s->filling = true;
+            }
+        }
+        generation = s->generation;
+        fill_buf = s->fill_buf;
+    }
+
+    if (!fill_bytes) {
+        return bdrv_co_preadv_part(bs->file, offset, bytes, qiov, qiov_offset,
+                                   flags);
+    }
+
+    ret = bdrv_co_pread(bs->file, offset, fill_bytes, fill_buf,
+                        flags & ~BDRV_REQ_REGISTERED_BUF);
+    if (ret >= 0) {
+        qemu_iovec_from_buf(qiov, qiov_offset, fill_buf, bytes);
+    }
+
+    WITH_QEMU_LOCK_GUARD(&s->lock) {
+        s->filling = false;
+        if (ret >= 0 && generation == s->generation) {
+            s->fill_buf = s->buf;
+            s->buf = fill_buf;
+            s->buf_offset = offset;
+            s->buf_bytes = fill_bytes;
+        }
+    }
+
+    return ret < 0 ? ret : 0;
+}
+
+static int coroutine_fn GRAPH_RDLOCK
+readahead_co_pwritev_part(BlockDriverState *bs, int64_t offset, int64_t bytes,
+                          QEMUIOVector *qiov, size_t qiov_offset,
+                          BdrvRequestFlags flags)
+{
+    BDRVReadaheadState *s = bs->opaque;
+    int ret;
+
+    readahead_invalidate(s, offset, bytes);
+    ret = bdrv_co_pwritev_part(bs->file, offset, bytes, qiov, qiov_offset,
+                               flags);
+    readahead_invalidate(s, offset, bytes);
+
+    return ret;
+}
+
+static int coroutine_fn GRAPH_RDLOCK
+readahead_co_pwrite_zeroes(BlockDriverState *bs, int64_t offset, int64_t bytes,
+                           BdrvRequestFlags flags)
+{
+    BDRVReadaheadState *s = bs->opaque;
+    int ret;
+
+    readahead_invalidate(s, offset, bytes);
+    ret = bdrv_co_pwrite_zeroes(bs->file, offset, bytes, flags);
+    readahead_invalidate(s, offset, bytes);
+
+    return ret;
+}
+
+static int coroutine_fn GRAPH_RDLOCK
+readahead_co_pdiscard(BlockDriverState *bs, int64_t offset, int64_t bytes)
+{
+    BDRVReadaheadState *s = bs->opaque;
+    int ret;
+
+    readahead_invalidate(s, offset, bytes);
+    ret = bdrv_co_pdiscard(bs->file, offset, bytes);
+    readahead_invalidate(s, offset, bytes);
+
+    return ret;
+}
+
+static int coroutine_fn GRAPH_RDLOCK readahead_co_flush(BlockDriverState *bs)
+{
+    return bdrv_co_flush(bs->file->bs);
+}
+
+static BlockDriver bdrv_readahead_filter = {
+    .format_name            = "readahead",
+    .instance_size          = sizeof(BDRVReadaheadState),
+
+    .bdrv_open              = readahead_open,
+    .bdrv_close             = readahead_close,
+    .bdrv_child_perm        = readahead_child_perm,
+
+    .bdrv_co_getlength      = readahead_co_getlength,
+
+    .bdrv_co_preadv_part    = readahead_co_preadv_part,
+    .bdrv_co_pwritev_part   = readahead_co_pwritev_part,
+    .bdrv_co_pwrite_zeroes  = readahead_co_pwrite_zeroes,
+    .bdrv_co_pdiscard       = readahead_co_pdiscard,
+    .bdrv_co_flush          = readahead_co_flush,
+
+    .is_filter              = true,
+};
+
+static void bdrv_readahead_init(void)
+{
+    bdrv_register(&bdrv_readahead_filter);
+}
+
+block_init(bdrv_readahead_init);
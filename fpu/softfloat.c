@@ -2871,6 +2871,22 @@ float32 float64_to_float32(float64 a, float_status *s)
 {
     FloatParts64 p;
 
+    if (likely(float64_is_normal(a)) && can_use_fpu(s)) {
+        union_float64 ud;
+        union_float32 uf;
+
+        /*
+         * Inexact is already set, so only overflow and underflow need
+         * the soft path to raise their flags and apply the target's
+         * tininess and flush-to-zero rules.
+         */
+        ud.s = a;
+        uf.h = ud.h;
+        if (likely(!f32_is_inf(uf) && fabsf(uf.h) > FLT_MIN)) {
+            return uf.s;
+        }
+    }
+
     float64_unpack_canonical(&p, a, s);
     parts_float_to_float(&p, s);
     return float32_round_pack_canonical(&p, s);
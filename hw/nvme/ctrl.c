@@ -1500,17 +1500,29 @@ static void nvme_post_cqes(void *opaque)
     bool pending = cq->head != cq->tail;
     int ret;
 
+    /*
+     * With shadow doorbells, sync the head once per batch and only re-read
+     * it when the queue looks full, instead of two DMA accesses per CQE.
+     */
+    if (n->dbbuf_enabled) {
+        nvme_update_cq_eventidx(cq);
+        nvme_update_cq_head(cq);
+    }
+
     QTAILQ_FOREACH_SAFE(req, &cq->req_list, entry, next) {
         NvmeSQueue *sq;
         hwaddr addr;
 
-        if (n->dbbuf_enabled) {
+        if (nvme_cq_full(cq)) {
+            if (!n->dbbuf_enabled) {
+                break;
+            }
+
             nvme_update_cq_eventidx(cq);
             nvme_update_cq_head(cq);
-        }
-
-        if (nvme_cq_full(cq)) {
-            break;
+            if (nvme_cq_full(cq)) {
+                break;
+            }
         }
 
         sq = req->sq;
@@ -119,14 +119,20 @@ static void vhost_dev_sync_region(struct vhost_dev *dev,
         log = qatomic_xchg(from, 0);
         while (log) {
             int bit = ctzl(log);
+            /* Mark each run of consecutive dirty pages with a single call */
+            int nr = ctzl(~(log >> bit));
             hwaddr page_addr;
             hwaddr section_offset;
             hwaddr mr_offset;
             page_addr = addr + bit * VHOST_LOG_PAGE;
             section_offset = page_addr - section->offset_within_address_space;
             mr_offset = section_offset + section->offset_within_region;
-            memory_region_set_dirty(section->mr, mr_offset, VHOST_LOG_PAGE);
-            log &= ~(0x1ull << bit);
+            memory_region_set_dirty(section->mr, mr_offset,
+                                    nr * VHOST_LOG_PAGE);
+            if (bit + nr == VHOST_LOG_BITS) {
+                break;
+            }
+            log &= ~0UL << (bit + nr);
         }
         addr += VHOST_LOG_CHUNK;
     }
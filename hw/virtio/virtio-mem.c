@@ -614,7 +614,13 @@ static int virtio_mem_set_block_state(VirtIOMEM *vmem, uint64_t start_gpa,
         int fd = memory_region_get_fd(&vmem->memdev->mr);
         Error *local_err = NULL;
 
-        if (!qemu_prealloc_mem(fd, area, size, 1, NULL, false, &local_err)) {
+        /*
+         * Use the memory backend's thread settings, large plug requests
+         * would otherwise be populated by a single thread.
+         */
+        if (!qemu_prealloc_mem(fd, area, size, vmem->memdev->prealloc_threads,
+                               vmem->memdev->prealloc_context, false,
+                               &local_err)) {
             static bool warned;
 
             /*
@@ -59,10 +59,14 @@ int coroutine_fn block_copy(BlockCopyState *s, int64_t offset, int64_t bytes,
  * must be > 0.
  *
  * @max_chunk means maximum length for one IO operation. Zero means unlimited.
+ *
+ * @adaptive_workers makes @max_workers an upper bound only: the number of
+ * parallel sub-requests is then tuned at runtime from observed throughput.
  */
 BlockCopyCallState *block_copy_async(BlockCopyState *s,
                                      int64_t offset, int64_t bytes,
                                      int max_workers, int64_t max_chunk,
+                                     bool adaptive_workers,
                                      BlockCopyAsyncCallbackFunc cb,
                                      void *cb_opaque);
 
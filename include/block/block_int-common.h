@@ -1066,6 +1066,23 @@ typedef struct BdrvBlockStatusCache {
     int64_t data_end;
 } BdrvBlockStatusCache;
 
+#define BDRV_LATENCY_NR_BINS 8
+
+/*
+ * Per-node request latency, from entering bdrv_co_preadv_part() or
+ * bdrv_co_pwritev_part() for the node until completion, i.e. including the
+ * time spent in its children.  @bins is a histogram over the fixed
+ * bdrv_latency_boundaries.
+ */
+typedef struct BdrvLatencyStats {
+    Stat64 ops;
+    Stat64 total_ns;
+    Stat64 max_ns;
+    Stat64 bins[BDRV_LATENCY_NR_BINS];
+} BdrvLatencyStats;
+
+extern const uint64_t bdrv_latency_boundaries[BDRV_LATENCY_NR_BINS - 1];
+
 struct BlockDriverState {
     /*
      * Protected by big QEMU lock or read-only after opening.  No special
@@ -1213,6 +1230,14 @@ struct BlockDriverState {
     /* Offset after the highest byte written to */
     Stat64 wr_highest_offset;
 
+    /*
+     * Request latency accounting for this node, only updated while
+     * @latency_accounting is true (accessed with atomic ops).
+     */
+    bool latency_accounting;
+    BdrvLatencyStats rd_latency;
+    BdrvLatencyStats wr_latency;
+
     /*
      * If true, copy read backing sectors into image.  Can be >1 if more
      * than one client has requested copy-on-read.  Accessed with atomic
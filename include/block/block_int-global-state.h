@@ -323,4 +323,10 @@ void bdrv_remove_aio_context_notifier(BlockDriverState *bs,
  */
 void bdrv_drain_all_end_quiesce(BlockDriverState *bs);
 
+/*
+ * Start or stop per-node request latency accounting for @bs.  Enabling it
+ * resets the counters.
+ */
+void bdrv_latency_accounting_set(BlockDriverState *bs, bool enable);
+
 #endif /* BLOCK_INT_GLOBAL_STATE_H */
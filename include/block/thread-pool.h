@@ -19,6 +19,7 @@
 #define QEMU_THREAD_POOL_H
 
 #include "block/aio.h"
+#include "qemu/coroutine.h"
 
 #define THREAD_POOL_MAX_THREADS_DEFAULT         64
 
@@ -38,6 +39,34 @@ BlockAIOCB *thread_pool_submit_aio(ThreadPoolFunc *func, void *arg,
 int coroutine_fn thread_pool_submit_co(ThreadPoolFunc *func, void *arg);
 void thread_pool_update_params(ThreadPoolAio *pool, struct AioContext *ctx);
 
+/*
+ * Bounds for the number of jobs one ThreadPoolLimit user may have in the
+ * thread pool at the same time; the actual limit follows the number of host
+ * CPUs within them.
+ */
+#define THREAD_POOL_LIMIT_MIN 4
+#define THREAD_POOL_LIMIT_MAX 16
+
+/*
+ * Caps the number of jobs that one user (e.g. an image doing compression or
+ * encryption) submits to the thread pool, so that it cannot monopolise it.
+ */
+typedef struct ThreadPoolLimit {
+    CoMutex lock;
+    CoQueue queue;
+    int in_flight;
+    int max;
+} ThreadPoolLimit;
+
+void thread_pool_limit_init(ThreadPoolLimit *limit);
+
+/*
+ * Like thread_pool_submit_co(), but first waits until @limit has room for
+ * another job.
+ */
+int coroutine_fn thread_pool_limit_submit_co(ThreadPoolLimit *limit,
+                                             ThreadPoolFunc *func, void *arg);
+
 /* ------------------------------------------- */
 /* Generic thread pool types and methods below */
 typedef struct ThreadPool ThreadPool;
@@ -201,6 +201,12 @@ struct CPUClass {
 /* Use a fully associative victim tlb of 8 entries. */
 #define CPU_VTLB_SIZE 8
 
+/*
+ * Number of distinct pages whose flush, requested by another cpu, may be
+ * queued before the request is widened to a flush of the whole mmu_idx.
+ */
+#define CPU_TLB_PENDING_SIZE 16
+
 /*
  * The full TLB entry, which is not accessed by generated TCG code,
  * so the layout is not as critical as that of CPUTLBEntry. This is
@@ -290,6 +296,17 @@ typedef struct CPUTLBDesc {
     CPUTLBEntryFull *fulltlb;
 } CPUTLBDesc;
 
+/*
+ * A page or range flush requested by another cpu, see CPUTLBCommon.
+ * @bits is 0 for a single page flush, in which case @len is unused.
+ */
+typedef struct CPUTLBPendingFlush {
+    vaddr addr;
+    vaddr len;
+    uint16_t idxmap;
+    uint16_t bits;
+} CPUTLBPendingFlush;
+
 /*
  * Data elements that are shared between all MMU modes.
  */
@@ -303,13 +320,28 @@ typedef struct CPUTLBCommon {
      */
     uint16_t dirty;
     /*
-     * Statistics.  These are not lock protected, but are read and
-     * written atomically.  This allows the monitor to print a snapshot
-     * of the stats without interfering with the cpu.
+     * Flushes requested by other cpus which have not been run yet.
+     * They are merged here and drained by a single queued work item,
+     * which is outstanding while pending_queued is set: pending_full
+     * holds the mmu_idx to be flushed entirely, pending[] the pages and
+     * ranges.
+     * Protected by tlb_c.lock.
+     */
+    bool pending_queued;
+    uint16_t pending_full;
+    uint16_t pending_count;
+    CPUTLBPendingFlush pending[CPU_TLB_PENDING_SIZE];
+    /*
+     * Statistics.  These are read and written atomically, which allows
+     * the monitor to print a snapshot of the stats without interfering
+     * with the cpu.  The flush counts are written only by the owning
+     * cpu; coalesced_flush_count is written by the requesting cpus, with
+     * tlb_c.lock held.
      */
     size_t full_flush_count;
     size_t part_flush_count;
     size_t elide_flush_count;
+    size_t coalesced_flush_count;
 } CPUTLBCommon;
 
 /*
@@ -82,26 +82,29 @@ void net_toeplitz_add(uint32_t *result,
                       uint32_t len,
                       net_toeplitz_key *key)
 {
-    register uint32_t accumulator = *result;
-    register uint32_t leftmost_32_bits = key->leftmost_32_bits;
-    register uint32_t byte;
+    uint32_t accumulator = *result;
+    uint32_t leftmost_32_bits = key->leftmost_32_bits;
+    uint32_t byte;
 
     for (byte = 0; byte < len; byte++) {
-        register uint8_t input_byte = input[byte];
-        register uint8_t key_byte = *(key->next_byte++);
-        register uint8_t bit;
-
-        for (bit = 0; bit < 8; bit++) {
-            if (input_byte & (1 << 7)) {
-                accumulator ^= leftmost_32_bits;
-            }
-
-            leftmost_32_bits =
-                (leftmost_32_bits << 1) | ((key_byte & (1 << 7)) >> 7);
-
+        uint8_t input_byte = input[byte];
+        /*
+         * The 32-bit key window for input bit @bit of this byte is
+         * (window >> (8 - bit)), so there is no need to shift the key one
+         * bit at a time.
+         */
+        uint64_t window = ((uint64_t)leftmost_32_bits << 8) |
+                          *(key->next_byte++);
+        int bit;
+
+        for (bit = 0; input_byte && bit < 8; bit++) {
+            uint32_t mask = -(uint32_t)(input_byte >> 7);
+
+            accumulator ^= (uint32_t)(window >> (8 - bit)) & mask;
             input_byte <<= 1;
-            key_byte <<= 1;
         }
+
+        leftmost_32_bits = (uint32_t)window;
     }
 
     key->leftmost_32_bits = leftmost_32_bits;
@@ -389,6 +389,9 @@ struct TCGContext {
     /* Threshold to flush the translated code buffer.  */
     void *code_gen_highwater;
 
+    /* Live values evicted from call-clobbered registers at helper calls. */
+    size_t call_spill_count;
+
     /* Track which vCPU triggers events */
     CPUState *cpu;                      /* *_trans */
 
@@ -637,6 +640,7 @@ void tcg_region_reset_all(void);
 
 size_t tcg_code_size(void);
 size_t tcg_code_capacity(void);
+size_t tcg_call_spill_count(void);
 
 /**
  * tcg_tb_insert:
@@ -64,6 +64,9 @@ typedef struct ThreadPool ThreadPool;
  */
 #define CLEAR_BITMAP_SHIFT_MAX            31
 
+/* Default upper bound, in host pages, of a postcopy fault request window */
+#define POSTCOPY_PREFETCH_PAGES_DEFAULT   16
+
 /* This is an abstraction of a "temp huge page" for postcopy's purpose */
 typedef struct {
     /*
@@ -127,6 +130,15 @@ struct MigrationIncomingState {
     QemuMutex rp_mutex;    /* We send replies from multiple threads */
     /* RAMBlock of last request sent to source */
     RAMBlock *last_rb;
+    /*
+     * Window of the last page request, [prefetch_start, prefetch_end) in
+     * prefetch_rb, and its size in host pages.  Only used by the fault
+     * thread to detect sequential faults.
+     */
+    RAMBlock *prefetch_rb;
+    ram_addr_t prefetch_start;
+    ram_addr_t prefetch_end;
+    uint32_t prefetch_pages;
     /*
      * Number of postcopy channels including the default precopy channel, so
      * vanilla postcopy will only contain one channel which contain both
@@ -493,6 +505,14 @@ struct MigrationState {
      */
     uint8_t clear_bitmap_shift;
 
+    /*
+     * Maximum number of host pages the destination requests for a single
+     * postcopy page fault.  When faults hit the pages right after the
+     * previous request, the request window doubles up to this size; any
+     * other fault only requests the faulted page.  1 disables prefetching.
+     */
+    uint32_t postcopy_prefetch_pages;
+
     /*
      * This save hostname when out-going migration starts
      */
@@ -546,9 +566,10 @@ void migrate_send_rp_shut(MigrationIncomingState *mis,
 void migrate_send_rp_pong(MigrationIncomingState *mis,
                           uint32_t value);
 int migrate_send_rp_req_pages(MigrationIncomingState *mis, RAMBlock *rb,
-                              ram_addr_t start, uint64_t haddr);
+                              ram_addr_t start, uint64_t haddr, size_t len);
 int migrate_send_rp_message_req_pages(MigrationIncomingState *mis,
-                                      RAMBlock *rb, ram_addr_t start);
+                                      RAMBlock *rb, ram_addr_t start,
+                                      size_t len);
 void migrate_send_rp_recv_bitmap(MigrationIncomingState *mis,
                                  char *block_name);
 void migrate_send_rp_resume_ack(MigrationIncomingState *mis, uint32_t value);
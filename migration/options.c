@@ -101,6 +101,9 @@ const Property migration_properties[] = {
                       clear_bitmap_shift, CLEAR_BITMAP_SHIFT_DEFAULT),
     DEFINE_PROP_BOOL("x-preempt-pre-7-2", MigrationState,
                      preempt_pre_7_2, false),
+    DEFINE_PROP_UINT32("x-postcopy-prefetch-pages", MigrationState,
+                       postcopy_prefetch_pages,
+                       POSTCOPY_PREFETCH_PAGES_DEFAULT),
     DEFINE_PROP_BOOL("multifd-clean-tls-termination", MigrationState,
                      multifd_clean_tls_termination, true),
 
@@ -18,6 +18,7 @@
 
 #include "qemu/osdep.h"
 #include "qemu/madvise.h"
+#include "qemu/units.h"
 #include "exec/target_page.h"
 #include "migration.h"
 #include "qemu-file.h"
@@ -752,6 +753,55 @@ int postcopy_wake_shared(struct PostCopyFD *pcfd,
                        pagesize);
 }
 
+/* Never ask for more than this in a single page request */
+#define POSTCOPY_PREFETCH_MAX_BYTES (64 * MiB)
+
+/*
+ * Returns the number of bytes to request from the source for a fault at
+ * @start.  A fault right after the start of the previous request window
+ * means the guest is walking memory sequentially, so the window doubles (up
+ * to x-postcopy-prefetch-pages host pages); any other fault requests just
+ * the faulted page.  The window ends early at the first page that does not
+ * need to be fetched.
+ */
+static size_t postcopy_prefetch_len(MigrationIncomingState *mis,
+                                    RAMBlock *rb, ram_addr_t start)
+{
+    size_t pagesize = qemu_ram_pagesize(rb);
+    ram_addr_t length = qemu_ram_get_used_length(rb);
+    uint32_t max_pages = migrate_get_current()->postcopy_prefetch_pages;
+    uint32_t pages;
+    ram_addr_t end;
+
+    max_pages = MIN(max_pages, POSTCOPY_PREFETCH_MAX_BYTES / pagesize);
+
+    if (rb == mis->prefetch_rb &&
+        start > mis->prefetch_start && start <= mis->prefetch_end) {
+        mis->prefetch_pages = MIN(mis->prefetch_pages * 2, max_pages);
+    } else {
+        mis->prefetch_pages = 1;
+    }
+    pages = MAX(mis->prefetch_pages, 1);
+
+    for (end = start + pagesize; --pages && end < length; end += pagesize) {
+        if (ramblock_recv_bitmap_test_byte_offset(rb, end) ||
+            ramblock_page_is_discarded(rb, end)) {
+            break;
+        }
+    }
+
+    mis->prefetch_rb = rb;
+    mis->prefetch_start = start;
+    mis->prefetch_end = end;
+
+    if (end - start > pagesize) {
+        trace_postcopy_request_page_prefetch(qemu_ram_get_idstr(rb), start,
+                                             end - start);
+    }
+
+    return end - start;
+}
+
 static int postcopy_request_page(MigrationIncomingState *mis, RAMBlock *rb,
                                  ram_addr_t start, uint64_t haddr)
 {
@@ -772,7 +822,8 @@ static int postcopy_request_page(MigrationIncomingState *mis, RAMBlock *rb,
         return received ? 0 : postcopy_place_page_zero(mis, aligned, rb);
     }
 
-    return migrate_send_rp_req_pages(mis, rb, start, haddr);
+    return migrate_send_rp_req_pages(mis, rb, start, haddr,
+                                     postcopy_prefetch_len(mis, rb, start));
 }
 
 /*
@@ -964,6 +1015,7 @@ static void *postcopy_ram_fault_thread(void *opaque)
     trace_postcopy_ram_fault_thread_entry();
     rcu_register_thread();
     mis->last_rb = NULL; /* last RAMBlock we sent part of */
+    mis->prefetch_rb = NULL;
     qemu_sem_post(&mis->thread_sync_sem);
 
     struct pollfd *pfd;
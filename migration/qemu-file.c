@@ -35,7 +35,11 @@
 #include "io/channel-file.h"
 
 #define IO_BUF_SIZE 32768
-#define MAX_IOV_SIZE MIN_CONST(IOV_MAX, 64)
+/*
+ * Each RAM page sent by reference takes two entries (header in buf, then the
+ * page itself), so this bounds how many pages go out in a single writev().
+ */
+#define MAX_IOV_SIZE MIN_CONST(IOV_MAX, 256)
 
 typedef struct FdEntry {
     QTAILQ_ENTRY(FdEntry) entry;
@@ -53,6 +57,7 @@ struct QEMUFile {
     DECLARE_BITMAP(may_free, MAX_IOV_SIZE);
     struct iovec iov[MAX_IOV_SIZE];
     unsigned int iovcnt;
+    size_t iov_bytes; /* total length of iov[0..iovcnt) */
 
     int last_error;
     Error *last_error_obj;
@@ -295,8 +300,7 @@ int qemu_fflush(QEMUFile *f)
                                    &local_error) < 0) {
             qemu_file_set_error_obj(f, -EIO, local_error);
         } else {
-            uint64_t size = iov_size(f->iov, f->iovcnt);
-            stat64_add(&mig_stats.qemu_file_transferred, size);
+            stat64_add(&mig_stats.qemu_file_transferred, f->iov_bytes);
         }
 
         qemu_iovec_release_ram(f);
@@ -304,6 +308,7 @@ int qemu_fflush(QEMUFile *f)
 
     f->buf_index = 0;
     f->iovcnt = 0;
+    f->iov_bytes = 0;
     return f->last_error;
 }
 
@@ -478,6 +483,7 @@ static int add_to_iovec(QEMUFile *f, const uint8_t *buf, size_t size,
         f->iov[f->iovcnt].iov_base = (uint8_t *)buf;
         f->iov[f->iovcnt++].iov_len = size;
     }
+    f->iov_bytes += size;
 
     if (f->iovcnt >= MAX_IOV_SIZE) {
         qemu_fflush(f);
@@ -795,16 +801,9 @@ int coroutine_mixed_fn qemu_get_byte(QEMUFile *f)
 
 uint64_t qemu_file_transferred(QEMUFile *f)
 {
-    uint64_t ret = stat64_get(&mig_stats.qemu_file_transferred);
-    int i;
-
     g_assert(qemu_file_is_writable(f));
 
-    for (i = 0; i < f->iovcnt; i++) {
-        ret += f->iov[i].iov_len;
-    }
-
-    return ret;
+    return stat64_get(&mig_stats.qemu_file_transferred) + f->iov_bytes;
 }
 
 void qemu_put_be16(QEMUFile *f, unsigned int v)
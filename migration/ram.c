@@ -66,6 +66,9 @@
 
 #if defined(__linux__)
 #include "qemu/userfaultfd.h"
+
+/* Number of UFFD write faults fetched from the kernel with a single read */
+#define UFFD_FAULT_BATCH 32
 #endif /* defined(__linux__) */
 
 /***********************************************************/
@@ -85,9 +88,12 @@
 
 /*
  * When doing mapped-ram migration, this is the amount we read from
- * the pages region in the migration file at a time.
+ * the pages region in the migration file at a time.  Reads go straight
+ * into guest memory, so this only bounds the size of a single pread();
+ * keep it large enough that restoring big guests is not dominated by
+ * per-request overhead and the multifd channel handoff.
  */
-#define MAPPED_RAM_LOAD_BUF_SIZE 0x100000
+#define MAPPED_RAM_LOAD_BUF_SIZE 0x800000
 
 XBZRLECacheStats xbzrle_counters;
 
@@ -341,6 +347,12 @@ struct RAMState {
     PageSearchStatus pss[RAM_CHANNEL_MAX];
     /* UFFD file descriptor, used in 'write-tracking' migration */
     int uffdio_fd;
+#if defined(__linux__)
+    /* Write faults read from uffdio_fd but not handled yet */
+    struct uffd_msg uffd_msgs[UFFD_FAULT_BATCH];
+    int uffd_msg_num;
+    int uffd_msg_next;
+#endif
     /* total ram size in bytes */
     uint64_t ram_bytes_total;
     /* Last block that we have visited searching for dirty pages */
@@ -1379,7 +1391,7 @@ static RAMBlock *unqueue_page(RAMState *rs, ram_addr_t *offset)
  */
 static RAMBlock *poll_fault_page(RAMState *rs, ram_addr_t *offset)
 {
-    struct uffd_msg uffd_msg;
+    struct uffd_msg *uffd_msg;
     void *page_address;
     RAMBlock *block;
     int res;
@@ -1388,12 +1400,23 @@ static RAMBlock *poll_fault_page(RAMState *rs, ram_addr_t *offset)
         return NULL;
     }
 
-    res = uffd_read_events(rs->uffdio_fd, &uffd_msg, 1);
-    if (res <= 0) {
-        return NULL;
+    /*
+     * Fetch pending faults in batches: when many vCPUs write at once this
+     * saves a read() per fault.  A buffered fault whose page meanwhile got
+     * saved by the linear scan is harmless, the page is no longer dirty and
+     * un-protecting it has already woken up the vCPU.
+     */
+    if (rs->uffd_msg_next == rs->uffd_msg_num) {
+        res = uffd_read_events(rs->uffdio_fd, rs->uffd_msgs, UFFD_FAULT_BATCH);
+        if (res <= 0) {
+            return NULL;
+        }
+        rs->uffd_msg_num = res;
+        rs->uffd_msg_next = 0;
     }
 
-    page_address = (void *)(uintptr_t) uffd_msg.arg.pagefault.address;
+    uffd_msg = &rs->uffd_msgs[rs->uffd_msg_next++];
+    page_address = (void *)(uintptr_t) uffd_msg->arg.pagefault.address;
     block = qemu_ram_block_from_host(page_address, false, offset);
     assert(block && (block->flags & RAM_UF_WRITEPROTECT) != 0);
     return block;
@@ -1630,6 +1653,8 @@ int ram_write_tracking_start(void)
         return uffd_fd;
     }
     rs->uffdio_fd = uffd_fd;
+    rs->uffd_msg_num = 0;
+    rs->uffd_msg_next = 0;
 
     RCU_READ_LOCK_GUARD();
 
@@ -1926,9 +1951,8 @@ int ram_save_queue_pages(const char *rbname, ram_addr_t start, ram_addr_t len,
              * will automatically be moved and point to the next host page
              * we're going to send, so no need to update here.
              *
-             * Normally QEMU never sends >1 host page in requests, so
-             * logically we don't even need that as the loop should only
-             * run once, but just to be consistent.
+             * The destination asks for more than one host page when it
+             * prefetches around sequential faults.
              */
             len -= page_size;
         };
@@ -1289,6 +1289,12 @@ static int compare_buffers(const uint8_t *buf1, const uint8_t *buf2,
 
     assert(bytes > 0);
 
+    /* Identical buffers are the common case, check them in one go */
+    if (!memcmp(buf1, buf2, bytes)) {
+        *pnum = bytes;
+        return 0;
+    }
+
     if (!chsize) {
         chsize = BDRV_SECTOR_SIZE;
     }
@@ -1348,6 +1354,36 @@ static int check_empty_sectors(BlockBackend *blk, int64_t offset,
     return 0;
 }
 
+static void compare_read_cb(void *opaque, int ret)
+{
+    *(int *)opaque = ret;
+}
+
+/*
+ * Read the same range from both images of 'qemu-img compare' at the same
+ * time, so that the latencies of the two images overlap.
+ */
+static int compare_read_both(BlockBackend *blk1, BlockBackend *blk2,
+                             int64_t offset, int64_t bytes,
+                             uint8_t *buf1, uint8_t *buf2, int *ret2)
+{
+    QEMUIOVector qiov1, qiov2;
+    int ret1 = -EINPROGRESS;
+
+    *ret2 = -EINPROGRESS;
+    qemu_iovec_init_buf(&qiov1, buf1, bytes);
+    qemu_iovec_init_buf(&qiov2, buf2, bytes);
+
+    blk_aio_preadv(blk1, offset, &qiov1, 0, compare_read_cb, &ret1);
+    blk_aio_preadv(blk2, offset, &qiov2, 0, compare_read_cb, ret2);
+
+    while (ret1 == -EINPROGRESS || *ret2 == -EINPROGRESS) {
+        main_loop_wait(false);
+    }
+
+    return ret1;
+}
+
 /*
  * Compares two images. Exit codes:
  *
@@ -1547,9 +1583,11 @@ static int img_compare(int argc, char **argv)
         } else if (allocated1 == allocated2) {
             if (allocated1) {
                 int64_t pnum;
+                int ret2;
 
                 chunk = MIN(chunk, IO_BUF_SIZE);
-                ret = blk_pread(blk1, offset, chunk, buf1, 0);
+                ret = compare_read_both(blk1, blk2, offset, chunk,
+                                        buf1, buf2, &ret2);
                 if (ret < 0) {
                     error_report("Error while reading offset %" PRId64
                                  " of %s: %s",
@@ -1557,11 +1595,10 @@ static int img_compare(int argc, char **argv)
                     ret = 4;
                     goto out;
                 }
-                ret = blk_pread(blk2, offset, chunk, buf2, 0);
-                if (ret < 0) {
+                if (ret2 < 0) {
                     error_report("Error while reading offset %" PRId64
                                  " of %s: %s",
-                                 offset, filename2, strerror(-ret));
+                                 offset, filename2, strerror(-ret2));
                     ret = 4;
                     goto out;
                 }
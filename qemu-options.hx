@@ -226,6 +226,7 @@ DEF("accel", HAS_ARG, QEMU_OPTION_accel,
     "                kernel-irqchip=on|off|split controls accelerated irqchip support (default=on)\n"
     "                kvm-shadow-mem=size of KVM shadow MMU in bytes\n"
     "                one-insn-per-tb=on|off (one guest instruction per TCG translation block)\n"
+    "                jmp-cache-stats=on|off (count TCG jump cache hits and indirect lookups, default=off)\n"
     "                split-wx=on|off (enable TCG split w^x mapping)\n"
     "                tb-size=n (TCG translation block cache size)\n"
     "                dirty-ring-size=n (KVM dirty ring GFN count, default 0)\n"
@@ -262,6 +263,12 @@ SRST
         can be useful in some situations, such as when trying to analyse
         the logs produced by the ``-d`` option.
 
+    ``jmp-cache-stats=on|off``
+        Makes the TCG accelerator count hits in the per-vCPU TB jump
+        cache and indirect branch lookups, as reported by ``info jit``.
+        Misses are always counted.  This adds a store to the fast path
+        of every TB lookup, so it is off by default.
+
     ``split-wx=on|off``
         Controls the use of split w^x mapping for the TCG code generation
         buffer. Some operating systems require this to be enabled, and in
@@ -21,6 +21,7 @@
 #include "crypto/aes.h"
 #include "crypto/aes-round.h"
 #include "crypto/clmul.h"
+#include "qemu/crc32c.h"
 
 #if SHIFT == 0
 #define Reg MMXReg
@@ -2113,18 +2114,13 @@ void glue(helper_pcmpistrm, SUFFIX)(CPUX86State *env, Reg *d, Reg *s,
     }
 }
 
-#define CRCPOLY        0x1edc6f41
-#define CRCPOLY_BITREV 0x82f63b78
 target_ulong helper_crc32(uint32_t crc1, target_ulong msg, uint32_t len)
 {
-    target_ulong crc = (msg & ((target_ulong) -1 >>
-                               (TARGET_LONG_BITS - len))) ^ crc1;
+    uint8_t buf[8];
 
-    while (len--) {
-        crc = (crc >> 1) ^ ((crc & 1) ? CRCPOLY_BITREV : 0);
-    }
-
-    return crc;
+    /* @len is 8, 16, 32 or 64 bits of @msg, consumed little-endian. */
+    stq_le_p(buf, msg);
+    return crc32c(crc1, buf, len / 8) ^ 0xffffffff;
 }
 
 #endif
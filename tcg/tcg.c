@@ -1014,6 +1014,25 @@ void tcg_register_thread(void)
 }
 #endif /* !CONFIG_USER_ONLY */
 
+/*
+ * Returns the number of live values that had to be moved out of
+ * call-clobbered host registers around helper calls, summed over
+ * all TCG contexts.
+ */
+size_t tcg_call_spill_count(void)
+{
+    unsigned int n_ctxs = qatomic_read(&tcg_cur_ctxs);
+    unsigned int i;
+    size_t total = 0;
+
+    for (i = 0; i < n_ctxs; i++) {
+        const TCGContext *s = qatomic_read(&tcg_ctxs[i]);
+
+        total += qatomic_read(&s->call_spill_count);
+    }
+    return total;
+}
+
 /* pool based memory allocation */
 void *tcg_malloc_internal(TCGContext *s, int size)
 {
@@ -5627,6 +5646,9 @@ static void tcg_reg_alloc_call(TCGContext *s, TCGOp *op)
     /* Clobber call registers.  */
     for (i = 0; i < TCG_TARGET_NB_REGS; i++) {
         if (tcg_regset_test_reg(tcg_target_call_clobber_regs, i)) {
+            if (s->reg_to_temp[i]) {
+                qatomic_set(&s->call_spill_count, s->call_spill_count + 1);
+            }
             tcg_reg_free(s, i, allocated_regs);
         }
     }
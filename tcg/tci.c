@@ -331,6 +331,30 @@ static void tci_qemu_st(CPUArchState *env, uint64_t taddr, uint64_t val,
     }
 }
 
+/*
+ * The code generator expands brcond into a setcond into TCG_REG_TMP,
+ * immediately followed by a brcond testing TCG_REG_TMP.  Having just
+ * executed the setcond into @r0 with result @cmp, look at the next
+ * instruction and perform such a branch right away, saving a trip
+ * through the dispatch switch for every conditional branch.
+ * Return the next instruction to execute.
+ */
+static const uint32_t *tci_fused_brcond(const uint32_t *tb_ptr,
+                                        TCGOpcode brcond, TCGReg r0,
+                                        bool cmp)
+{
+    uint32_t insn = *tb_ptr;
+    TCGReg r;
+    void *ptr;
+
+    if (extract32(insn, 0, 8) != brcond || extract32(insn, 8, 4) != r0) {
+        return tb_ptr;
+    }
+    tb_ptr++;
+    tci_args_rl(insn, tb_ptr, &r, &ptr);
+    return cmp ? ptr : tb_ptr;
+}
+
 #if TCG_TARGET_REG_BITS == 64
 # define CASE_32_64(x) \
         case glue(glue(INDEX_op_, x), _i64): \
@@ -439,6 +463,8 @@ uintptr_t QEMU_DISABLE_CFI tcg_qemu_tb_exec(CPUArchState *env,
         case INDEX_op_setcond_i32:
             tci_args_rrrc(insn, &r0, &r1, &r2, &condition);
             regs[r0] = tci_compare32(regs[r1], regs[r2], condition);
+            tb_ptr = tci_fused_brcond(tb_ptr, INDEX_op_brcond_i32,
+                                      r0, regs[r0]);
             break;
         case INDEX_op_movcond_i32:
             tci_args_rrrrrc(insn, &r0, &r1, &r2, &r3, &r4, &condition);
@@ -451,11 +477,15 @@ uintptr_t QEMU_DISABLE_CFI tcg_qemu_tb_exec(CPUArchState *env,
             T1 = tci_uint64(regs[r2], regs[r1]);
             T2 = tci_uint64(regs[r4], regs[r3]);
             regs[r0] = tci_compare64(T1, T2, condition);
+            tb_ptr = tci_fused_brcond(tb_ptr, INDEX_op_brcond_i32,
+                                      r0, regs[r0]);
             break;
 #elif TCG_TARGET_REG_BITS == 64
         case INDEX_op_setcond_i64:
             tci_args_rrrc(insn, &r0, &r1, &r2, &condition);
             regs[r0] = tci_compare64(regs[r1], regs[r2], condition);
+            tb_ptr = tci_fused_brcond(tb_ptr, INDEX_op_brcond_i64,
+                                      r0, regs[r0]);
             break;
         case INDEX_op_movcond_i64:
             tci_args_rrrrrc(insn, &r0, &r1, &r2, &r3, &r4, &condition);
@@ -0,0 +1,113 @@
+/*
+ * QEMU event loop and coroutine speed benchmark
+ *
+ * This work is licensed under the terms of the GNU GPL, version 2 or
+ * (at your option) any later version.  See the COPYING file in the
+ * top-level directory.
+ */
+#include "qemu/osdep.h"
+#include "block/aio.h"
+#include "qapi/error.h"
+#include "qemu/coroutine.h"
+#include "qemu/main-loop.h"
+
+static AioContext *ctx;
+
+static void report(const char *name, double ops)
+{
+    g_test_message("aio: %-20s %10.0f Kops/sec", name,
+                   ops / 1000 / g_test_timer_last());
+}
+
+static void bh_cb(void *opaque)
+{
+    unsigned *count = opaque;
+
+    (*count)++;
+}
+
+/* One qemu_bh_schedule() plus the aio_poll() that runs it */
+static void test_bh_roundtrip(void)
+{
+    unsigned count = 0;
+    QEMUBH *bh = aio_bh_new(ctx, bh_cb, &count);
+    double total = 0;
+
+    g_test_timer_start();
+    do {
+        for (int i = 0; i < 1000; i++) {
+            qemu_bh_schedule(bh);
+            aio_poll(ctx, false);
+        }
+        total += 1000;
+    } while (g_test_timer_elapsed() < 0.5);
+
+    g_assert_cmpuint(count, ==, total);
+    report("bh-roundtrip", total);
+    qemu_bh_delete(bh);
+}
+
+static void coroutine_fn co_empty(void *opaque)
+{
+}
+
+/* Coroutine creation from the pool, first entry and termination */
+static void test_coroutine_lifecycle(void)
+{
+    double total = 0;
+
+    g_test_timer_start();
+    do {
+        for (int i = 0; i < 1000; i++) {
+            qemu_coroutine_enter(qemu_coroutine_create(co_empty, NULL));
+        }
+        total += 1000;
+    } while (g_test_timer_elapsed() < 0.5);
+
+    report("coroutine-lifecycle", total);
+}
+
+static void coroutine_fn co_yield_loop(void *opaque)
+{
+    bool *done = opaque;
+
+    while (!*done) {
+        qemu_coroutine_yield();
+    }
+}
+
+/* A qemu_coroutine_enter() into a coroutine and its yield back */
+static void test_coroutine_switch(void)
+{
+    bool done = false;
+    Coroutine *co = qemu_coroutine_create(co_yield_loop, &done);
+    double total = 0;
+
+    g_test_timer_start();
+    do {
+        for (int i = 0; i < 1000; i++) {
+            qemu_coroutine_enter(co);
+        }
+        total += 1000;
+    } while (g_test_timer_elapsed() < 0.5);
+
+    report("coroutine-switch", total);
+    done = true;
+    qemu_coroutine_enter(co);
+}
+
+int main(int argc, char **argv)
+{
+    qemu_init_main_loop(&error_fatal);
+    ctx = qemu_get_aio_context();
+
+    while (g_main_context_iteration(NULL, false)) {
+        /* Drain pending main loop work before measuring */
+    }
+
+    g_test_init(&argc, &argv, NULL);
+    g_test_add_func("/aio/speed/bh-roundtrip", test_bh_roundtrip);
+    g_test_add_func("/aio/speed/coroutine-lifecycle", test_coroutine_lifecycle);
+    g_test_add_func("/aio/speed/coroutine-switch", test_coroutine_switch);
+    return g_test_run();
+}
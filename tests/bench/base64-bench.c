@@ -0,0 +1,51 @@
+/*
+ * QEMU base64 decoding speed benchmark
+ *
+ * This work is licensed under the terms of the GNU GPL, version 2 or
+ * (at your option) any later version.  See the COPYING file in the
+ * top-level directory.
+ */
+#include "qemu/osdep.h"
+#include "qapi/error.h"
+#include "qemu/base64.h"
+#include "qemu/units.h"
+
+static void test(const void *opaque)
+{
+    size_t max = 1 * MiB;
+    uint8_t *buf = g_malloc(max);
+
+    for (size_t i = 0; i < max; i++) {
+        buf[i] = i * 7;
+    }
+
+    for (size_t len = 64; len <= max; len *= 16) {
+        g_autofree char *input = g_base64_encode(buf, len);
+        size_t in_len = strlen(input);
+        double total = 0.0;
+
+        g_test_timer_start();
+        do {
+            size_t out_len;
+            uint8_t *out = qbase64_decode(input, in_len, &out_len,
+                                          &error_abort);
+
+            g_assert_cmpuint(out_len, ==, len);
+            g_free(out);
+            total += in_len;
+        } while (g_test_timer_elapsed() < 0.5);
+
+        total /= MiB;
+        g_test_message("base64: %7zu bytes %8.0f MB/sec",
+                       len, total / g_test_timer_last());
+    }
+
+    g_free(buf);
+}
+
+int main(int argc, char **argv)
+{
+    g_test_init(&argc, &argv, NULL);
+    g_test_add_data_func("/base64/speed", NULL, test);
+    return g_test_run();
+}
@@ -0,0 +1,45 @@
+/*
+ * QEMU crc32c speed benchmark
+ *
+ * This work is licensed under the terms of the GNU GPL, version 2 or
+ * (at your option) any later version.  See the COPYING file in the
+ * top-level directory.
+ */
+#include "qemu/osdep.h"
+#include "qemu/crc32c.h"
+#include "qemu/units.h"
+
+static void test(const void *opaque)
+{
+    size_t max = 64 * KiB;
+    uint8_t *buf = g_malloc(max);
+    uint32_t crc = 0;
+
+    for (size_t i = 0; i < max; i++) {
+        buf[i] = i * 7;
+    }
+
+    /* Start at 8 bytes: the size of the guest CRC32 instructions.  */
+    for (size_t len = 8; len <= max; len *= 8) {
+        double total = 0.0;
+
+        g_test_timer_start();
+        do {
+            crc = crc32c(crc, buf, len);
+            total += len;
+        } while (g_test_timer_elapsed() < 0.5);
+
+        total /= MiB;
+        g_test_message("crc32c: %6zu bytes %8.0f MB/sec (crc %08x)",
+                       len, total / g_test_timer_last(), crc);
+    }
+
+    g_free(buf);
+}
+
+int main(int argc, char **argv)
+{
+    g_test_init(&argc, &argv, NULL);
+    g_test_add_data_func("/crc32c/speed", NULL, test);
+    return g_test_run();
+}
@@ -21,6 +21,8 @@ struct thread_stats {
     size_t not_rm;
     size_t rz;
     size_t not_rz;
+    int64_t rz_us;      /* time spent in successful resizes */
+    int64_t rz_max_us;  /* longest successful resize */
 };
 
 struct thread_info {
@@ -142,13 +144,18 @@ static void do_rz(struct thread_info *info)
 
     if (r < resize_threshold) {
         size_t size = info->resize_down ? resize_min : resize_max;
+        int64_t start = g_get_monotonic_time();
+        int64_t delta;
         bool resized;
 
         resized = qht_resize(&ht, size);
+        delta = g_get_monotonic_time() - start;
         info->resize_down = !info->resize_down;
 
         if (resized) {
             stats->rz++;
+            stats->rz_us += delta;
+            stats->rz_max_us = MAX(stats->rz_max_us, delta);
         } else {
             stats->not_rz++;
         }
@@ -384,6 +391,8 @@ static void add_stats(struct thread_stats *s, struct thread_info *info, int n)
 
         s->rz += stats->rz;
         s->not_rz += stats->not_rz;
+        s->rz_us += stats->rz_us;
+        s->rz_max_us = MAX(s->rz_max_us, stats->rz_max_us);
     }
 }
 
@@ -400,6 +409,10 @@ static void pr_stats(void)
     if (resize_rate) {
         printf(" Resizes:           %zu (%.2f%% of %zu)\n",
                s.rz, (double)s.rz / (s.rz + s.not_rz) * 100, s.rz + s.not_rz);
+        if (s.rz) {
+            printf(" Resize time:       %.2f us avg, %" PRId64 " us max\n",
+                   (double)s.rz_us / s.rz, s.rz_max_us);
+        }
     }
 
     printf(" Read:              %.2f M (%.2f%% of %.2fM)\n",
@@ -81,14 +81,12 @@ static unsigned int write_to_buffer(unsigned int idx, void *dataptr, size_t size
 
 static void clear_buffer_range(unsigned int idx, size_t len)
 {
-    uint32_t num = 0;
-    while (num < len) {
-        if (idx >= TRACE_BUF_LEN) {
-            idx = idx % TRACE_BUF_LEN;
-        }
-        trace_buf[idx++] = 0;
-        num++;
-    }
+    size_t chunk;
+
+    idx %= TRACE_BUF_LEN;
+    chunk = MIN(len, TRACE_BUF_LEN - idx);
+    memset(&trace_buf[idx], 0, chunk);
+    memset(trace_buf, 0, len - chunk);
 }
 /**
  * Read a trace record from the trace buffer
@@ -241,29 +239,33 @@ int trace_record_start(TraceBufferRecord *rec, uint32_t event, size_t datasize)
     return 0;
 }
 
+/*
+ * Records may wrap around the end of trace_buf, so copies are done in at
+ * most two pieces.  @size is always smaller than TRACE_BUF_LEN.
+ */
 static void read_from_buffer(unsigned int idx, void *dataptr, size_t size)
 {
     uint8_t *data_ptr = dataptr;
-    uint32_t x = 0;
-    while (x < size) {
-        if (idx >= TRACE_BUF_LEN) {
-            idx = idx % TRACE_BUF_LEN;
-        }
-        data_ptr[x++] = trace_buf[idx++];
-    }
+    size_t chunk;
+
+    idx %= TRACE_BUF_LEN;
+    chunk = MIN(size, TRACE_BUF_LEN - idx);
+    memcpy(data_ptr, &trace_buf[idx], chunk);
+    memcpy(data_ptr + chunk, trace_buf, size - chunk);
 }
 
 static unsigned int write_to_buffer(unsigned int idx, void *dataptr, size_t size)
 {
     uint8_t *data_ptr = dataptr;
-    uint32_t x = 0;
-    while (x < size) {
-        if (idx >= TRACE_BUF_LEN) {
-            idx = idx % TRACE_BUF_LEN;
-        }
-        trace_buf[idx++] = data_ptr[x++];
-    }
-    return idx; /* most callers wants to know where to write next */
+    size_t chunk;
+
+    idx %= TRACE_BUF_LEN;
+    chunk = MIN(size, TRACE_BUF_LEN - idx);
+    memcpy(&trace_buf[idx], data_ptr, chunk);
+    memcpy(trace_buf, data_ptr + chunk, size - chunk);
+
+    /* most callers wants to know where to write next */
+    return (idx + size) % TRACE_BUF_LEN;
 }
 
 void trace_record_finish(TraceBufferRecord *rec)
@@ -27,6 +27,11 @@
 
 #include "qemu/osdep.h"
 #include "qemu/crc32c.h"
+#include "qemu/bswap.h"
+#if defined(__x86_64__)
+#include "host/cpuinfo.h"
+#include <immintrin.h>
+#endif
 
 /*
  * This is the CRC-32C table
@@ -105,8 +110,31 @@ static const uint32_t crc32c_table[256] = {
 };
 
 
+#if defined(__x86_64__)
+/* The SSE4.2 CRC32 instruction computes exactly this polynomial. */
+static uint32_t __attribute__((target("sse4.2")))
+crc32c_sse42(uint32_t crc, const uint8_t *data, unsigned int length)
+{
+    uint64_t crc64 = crc;
+
+    for (; length >= 8; length -= 8, data += 8) {
+        crc64 = _mm_crc32_u64(crc64, ldq_le_p(data));
+    }
+    crc = crc64;
+    while (length--) {
+        crc = _mm_crc32_u8(crc, *data++);
+    }
+    return crc ^ 0xffffffff;
+}
+#endif
+
 uint32_t crc32c(uint32_t crc, const uint8_t *data, unsigned int length)
 {
+#if defined(__x86_64__)
+    if (cpuinfo & CPUINFO_SSE4_2) {
+        return crc32c_sse42(crc, data, length);
+    }
+#endif
     while (length--) {
         crc = crc32c_table[(crc ^ *data++) & 0xFFL] ^ (crc >> 8);
     }
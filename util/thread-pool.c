@@ -290,6 +290,37 @@ int coroutine_fn thread_pool_submit_co(ThreadPoolFunc *func, void *arg)
     return tpc.ret;
 }
 
+void thread_pool_limit_init(ThreadPoolLimit *limit)
+{
+    qemu_co_mutex_init(&limit->lock);
+    qemu_co_queue_init(&limit->queue);
+    limit->in_flight = 0;
+    limit->max = MIN(MAX(g_get_num_processors(), THREAD_POOL_LIMIT_MIN),
+                     THREAD_POOL_LIMIT_MAX);
+}
+
+int coroutine_fn thread_pool_limit_submit_co(ThreadPoolLimit *limit,
+                                             ThreadPoolFunc *func, void *arg)
+{
+    int ret;
+
+    qemu_co_mutex_lock(&limit->lock);
+    while (limit->in_flight >= limit->max) {
+        qemu_co_queue_wait(&limit->queue, &limit->lock);
+    }
+    limit->in_flight++;
+    qemu_co_mutex_unlock(&limit->lock);
+
+    ret = thread_pool_submit_co(func, arg);
+
+    qemu_co_mutex_lock(&limit->lock);
+    limit->in_flight--;
+    qemu_co_queue_next(&limit->queue);
+    qemu_co_mutex_unlock(&limit->lock);
+
+    return ret;
+}
+
 void thread_pool_update_params(ThreadPoolAio *pool, AioContext *ctx)
 {
     qemu_mutex_lock(&pool->lock);